@@ -0,0 +1,33 @@
+/*
+ * @file append.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/avltree.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/splaytree.hpp>
+#include <chrono>
+#include <iostream>
+
+template <typename Tree>
+void benchmark(const char * name, int size, int count) {
+  Tree tree;
+  for (int i = 0; i < size; i++) {
+    tree.insert(i, i);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = size; i < size + count; i++) {
+    tree.insert(i, i);
+  }
+  std::chrono::duration <double, std::nano> append = std::chrono::steady_clock::now() - start;
+  std::cout << name << " size " << size << ": " << append.count() / count << " ns per append, height " << tree.height() << std::endl;
+}
+
+int main() {
+  for (int size : {1 << 10, 1 << 14, 1 << 18, 1 << 22}) {
+    benchmark <forest::avltree <int, int> >("avltree", size, 1 << 16);
+    benchmark <forest::rbtree <int, int> >("rbtree", size, 1 << 16);
+    benchmark <forest::splaytree <int, int> >("splaytree", size, 1 << 16);
+  }
+  return 0;
+}
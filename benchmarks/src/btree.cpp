@@ -0,0 +1,54 @@
+/*
+ * @file btree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/avltree.hpp>
+#include <forest/btree.hpp>
+#include <forest/rbtree.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template <typename Tree>
+void benchmark(const char * name, size_t size) {
+  std::mt19937 generator(1);
+  std::vector <int> keys;
+  for (size_t i = 0; i < size; i++) {
+    keys.push_back(static_cast<int>(generator()));
+  }
+
+  Tree tree;
+  auto start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    tree.insert(key, key);
+  }
+  std::chrono::duration <double, std::milli> insert = std::chrono::steady_clock::now() - start;
+
+  std::shuffle(keys.begin(), keys.end(), generator);
+  long sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    sum += tree.search(key)->value;
+  }
+  std::chrono::duration <double, std::milli> search = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    tree.erase(key);
+  }
+  std::chrono::duration <double, std::milli> erase = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << " size " << size << ": insert " << insert.count() << " ms, search " << search.count() << " ms, erase " << erase.count() << " ms (" << sum << ")" << std::endl;
+}
+
+int main() {
+  for (size_t size : {10000, 1000000, 4000000}) {
+    benchmark <forest::avltree <int, int> >("avltree", size);
+    benchmark <forest::rbtree <int, int> >("rbtree", size);
+    benchmark <forest::btree <int, int> >("btree", size);
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * @file compact_tree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/avltree.hpp>
+#include <forest/compact_avltree.hpp>
+#include <forest/compact_rbtree.hpp>
+#include <forest/rbtree.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+size_t allocated = 0;
+
+template <typename T>
+class counting_allocator {
+public:
+  using value_type = T;
+  counting_allocator() = default;
+  template <typename V>
+  counting_allocator(const counting_allocator <V> &) noexcept {
+
+  }
+  T * allocate(size_t n) {
+    allocated += n * sizeof(T);
+    return std::allocator <T>().allocate(n);
+  }
+  void deallocate(T * p, size_t n) noexcept {
+    allocated -= n * sizeof(T);
+    std::allocator <T>().deallocate(p, n);
+  }
+  friend bool operator==(const counting_allocator &, const counting_allocator &) noexcept {
+    return true;
+  }
+  friend bool operator!=(const counting_allocator &, const counting_allocator &) noexcept {
+    return false;
+  }
+};
+
+template <template <typename, typename, typename, typename> class Tree>
+void benchmark(const char * name, size_t size) {
+  std::mt19937 generator(1);
+  std::vector <int> keys;
+  for (size_t i = 0; i < size; i++) {
+    keys.push_back(static_cast<int>(generator()));
+  }
+
+  Tree <int, int, std::less <int>, counting_allocator <std::pair <const int, int> > > tree;
+  auto start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    tree.insert(key, key);
+  }
+  std::chrono::duration <double, std::milli> insert = std::chrono::steady_clock::now() - start;
+  const double bytes = static_cast<double>(allocated) / tree.size();
+
+  std::shuffle(keys.begin(), keys.end(), generator);
+  long sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    sum += tree.search(key)->value;
+  }
+  std::chrono::duration <double, std::milli> search = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    tree.erase(key);
+  }
+  std::chrono::duration <double, std::milli> erase = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << " size " << size << ": " << bytes << " bytes per entry, insert " << insert.count() << " ms, search " << search.count() << " ms, erase " << erase.count() << " ms (" << sum << ")" << std::endl;
+}
+
+int main() {
+  for (size_t size : {10000, 1000000, 4000000}) {
+    benchmark <forest::avltree>("avltree", size);
+    benchmark <forest::compact_avltree>("compact_avltree", size);
+    benchmark <forest::rbtree>("rbtree", size);
+    benchmark <forest::compact_rbtree>("compact_rbtree", size);
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * @file frozen_map.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/frozen_map.hpp>
+#include <forest/rbtree.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+void benchmark(size_t size, size_t lookups) {
+  std::mt19937 generator(1);
+  std::vector <std::pair <int, int> > elements;
+  for (size_t i = 0; i < size; i++) {
+    elements.emplace_back(static_cast<int>(i * 2), static_cast<int>(i));
+  }
+  std::vector <int> keys;
+  for (size_t i = 0; i < lookups; i++) {
+    keys.push_back(static_cast<int>(generator() % (2 * size)));
+  }
+
+  forest::rbtree <int, int> rbtree(elements.begin(), elements.end());
+  long found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    found += rbtree.search(key) != nullptr;
+  }
+  std::chrono::duration <double, std::milli> tree = std::chrono::steady_clock::now() - start;
+
+  forest::frozen_map <int, int> frozen {rbtree.freeze()};
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    found -= frozen.search(key) != nullptr;
+  }
+  std::chrono::duration <double, std::milli> map = std::chrono::steady_clock::now() - start;
+
+  std::cout << "size " << size << " lookups " << lookups << ": rbtree::search " << tree.count() << " ms, frozen_map::search " << map.count() << " ms" << (found ? " (mismatch)" : "") << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+  std::vector <size_t> sizes {1000000, 10000000};
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; i++) {
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+  }
+  for (size_t size : sizes) {
+    benchmark(size, 10000000);
+  }
+  return 0;
+}
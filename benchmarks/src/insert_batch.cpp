@@ -0,0 +1,49 @@
+/*
+ * @file insert_batch.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/avltree.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/splaytree.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+template <typename Tree>
+void benchmark(const char * name, size_t size, size_t count) {
+  std::mt19937 generator(1);
+  std::vector <std::pair <int, int> > elements;
+  std::vector <std::pair <int, int> > batch;
+  for (size_t i = 0; i < size; i++) {
+    elements.emplace_back(static_cast<int>(generator()), 0);
+  }
+  for (size_t i = 0; i < count; i++) {
+    batch.emplace_back(static_cast<int>(generator()), 1);
+  }
+
+  Tree looped(elements.begin(), elements.end());
+  auto start = std::chrono::steady_clock::now();
+  for (const auto & element : batch) {
+    looped.insert(element.first, element.second);
+  }
+  std::chrono::duration <double, std::milli> loop = std::chrono::steady_clock::now() - start;
+
+  Tree batched(elements.begin(), elements.end());
+  start = std::chrono::steady_clock::now();
+  batched.insert_batch(batch.begin(), batch.end());
+  std::chrono::duration <double, std::milli> insert_batch = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << " size " << size << " batch " << count << ": insert " << loop.count() << " ms, insert_batch " << insert_batch.count() << " ms" << std::endl;
+}
+
+int main() {
+  for (size_t count : {10000, 100000, 1000000}) {
+    benchmark <forest::avltree <int, int> >("avltree", 1000000, count);
+    benchmark <forest::rbtree <int, int> >("rbtree", 1000000, count);
+    benchmark <forest::splaytree <int, int> >("splaytree", 1000000, count);
+  }
+  return 0;
+}
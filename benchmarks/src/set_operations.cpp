@@ -0,0 +1,59 @@
+/*
+ * @file set_operations.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/avltree.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/thread_pool.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+template <typename Tree>
+Tree make_tree(std::mt19937 & generator, size_t size) {
+  std::vector <std::pair <int, int> > elements;
+  for (size_t i = 0; i < size; i++) {
+    elements.emplace_back(static_cast<int>(generator()), 0);
+  }
+  return Tree(elements.begin(), elements.end());
+}
+
+template <typename Tree>
+void benchmark(const char * name, size_t size, size_t count, forest::thread_pool & pool) {
+  std::mt19937 generator(1);
+  Tree looped {make_tree <Tree>(generator, size)};
+  Tree other {make_tree <Tree>(generator, count)};
+  auto start = std::chrono::steady_clock::now();
+  for (const auto & node : other) {
+    looped.insert(node.key, node.value);
+  }
+  std::chrono::duration <double, std::milli> loop = std::chrono::steady_clock::now() - start;
+
+  generator.seed(1);
+  Tree sequential {make_tree <Tree>(generator, size)};
+  other = make_tree <Tree>(generator, count);
+  start = std::chrono::steady_clock::now();
+  sequential.union_with(std::move(other));
+  std::chrono::duration <double, std::milli> union_with = std::chrono::steady_clock::now() - start;
+
+  generator.seed(1);
+  Tree parallel {make_tree <Tree>(generator, size)};
+  other = make_tree <Tree>(generator, count);
+  start = std::chrono::steady_clock::now();
+  parallel.union_with(std::move(other), pool);
+  std::chrono::duration <double, std::milli> parallel_union_with = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << " size " << size << " other " << count << ": insert " << loop.count() << " ms, union_with " << union_with.count() << " ms, union_with on " << pool.size() << " threads " << parallel_union_with.count() << " ms" << std::endl;
+}
+
+int main() {
+  forest::thread_pool pool;
+  for (size_t count : {10000, 100000, 1000000}) {
+    benchmark <forest::avltree <int, int> >("avltree", 1000000, count, pool);
+    benchmark <forest::rbtree <int, int> >("rbtree", 1000000, count, pool);
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * @file splay_policies.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/splaytree.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+template <typename Policy>
+void benchmark(const char * name, const Policy & policy, const std::vector <int> & keys, const std::vector <int> & lookups) {
+  forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, Policy> splaytree(policy);
+  for (int key : keys) {
+    splaytree.insert(key, key);
+  }
+
+  long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int key : lookups) {
+    sum += splaytree.search(key)->value;
+  }
+  std::chrono::duration <double, std::milli> search = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ": search " << search.count() << " ms (" << sum << ")" << std::endl;
+}
+
+int main() {
+  const size_t size = 1000000;
+  const size_t count = 10000000;
+  const double skew = 1.2;
+  std::mt19937 generator(1);
+  std::vector <int> keys;
+  for (size_t i = 0; i < size; i++) {
+    keys.push_back(static_cast<int>(i));
+  }
+  std::shuffle(keys.begin(), keys.end(), generator);
+  std::vector <int> popularity(keys);
+  std::shuffle(popularity.begin(), popularity.end(), generator);
+  std::vector <double> cumulative;
+  double total = 0;
+  for (size_t i = 1; i <= size; i++) {
+    total += 1.0 / std::pow(static_cast<double>(i), skew);
+    cumulative.push_back(total);
+  }
+  std::uniform_real_distribution <double> distribution(0.0, total);
+  std::vector <int> lookups;
+  for (size_t i = 0; i < count; i++) {
+    size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), distribution(generator)) - cumulative.begin();
+    lookups.push_back(popularity[std::min(rank, size - 1)]);
+  }
+
+  benchmark("no splay", forest::probabilistic_splay(0.0), keys, lookups);
+  benchmark("full_splay", forest::full_splay(), keys, lookups);
+  benchmark("semi_splay", forest::semi_splay(), keys, lookups);
+  benchmark("probabilistic_splay(0.1)", forest::probabilistic_splay(0.1), keys, lookups);
+  benchmark("depth_threshold_splay(16)", forest::depth_threshold_splay(16), keys, lookups);
+  benchmark("depth_threshold_splay(24)", forest::depth_threshold_splay(24), keys, lookups);
+  return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * @file static_index.cpp
+ * @author George Fotopoulos
+ */
+
+#include <forest/frozen_map.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/static_index.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+template <typename Index>
+double measure(Index & index, const std::vector <int> & keys, long & found) {
+  auto start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    found += index.search(key) != nullptr;
+  }
+  std::chrono::duration <double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+void benchmark(size_t size, size_t lookups) {
+  std::mt19937 generator(1);
+  std::vector <std::pair <int, int> > elements;
+  for (size_t i = 0; i < size; i++) {
+    elements.emplace_back(static_cast<int>(i * 2), static_cast<int>(i));
+  }
+  std::vector <int> keys;
+  for (size_t i = 0; i < lookups; i++) {
+    keys.push_back(static_cast<int>(generator() % (2 * size)));
+  }
+
+  forest::rbtree <int, int> rbtree(elements.begin(), elements.end());
+  forest::frozen_map <int, int> frozen {rbtree.freeze()};
+  forest::static_index <int, int> index(rbtree.begin(), rbtree.end());
+  long found = 0;
+  double tree = measure(rbtree, keys, found);
+  double map = measure(frozen, keys, found);
+  double simd = measure(index, keys, found);
+
+  std::cout << "size " << size << " lookups " << lookups << ": rbtree " << tree << " ms, frozen_map " << map << " ms, static_index " << simd << " ms (" << found << ")" << std::endl;
+}
+
+int main(int argc, char * argv[]) {
+  std::vector <size_t> sizes {1000, 1000000, 10000000};
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; i++) {
+      sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+  }
+  for (size_t size : sizes) {
+    benchmark(size, 10000000);
+  }
+  return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file arena.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace forest {
+  class arena {
+  private:
+    class chunk {
+    public:
+      chunk * next {nullptr};
+    };
+    class slab {
+    public:
+      size_t size {0};
+      size_t alignment {0};
+      void * free_list {nullptr};
+      slab * next {nullptr};
+    };
+    size_t chunk_size {65536};
+    chunk * chunks {nullptr};
+    char * current {nullptr};
+    char * end {nullptr};
+    slab * slabs {nullptr};
+    slab * find_slab(size_t size, size_t alignment) noexcept {
+      for (slab * candidate {slabs}; candidate; candidate = candidate->next) {
+        if (candidate->size == size && candidate->alignment == alignment) return candidate;
+      }
+      return nullptr;
+    }
+    void * carve(size_t size, size_t alignment) {
+      void * storage {bump(size, alignment)};
+      if (!storage) {
+        grow(size, alignment);
+        storage = bump(size, alignment);
+      }
+      return storage;
+    }
+    void * bump(size_t size, size_t alignment) noexcept {
+      if (!current) return nullptr;
+      std::uintptr_t address {reinterpret_cast<std::uintptr_t>(current)};
+      std::uintptr_t aligned {(address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1)};
+      if (aligned + size > reinterpret_cast<std::uintptr_t>(end)) return nullptr;
+      current = reinterpret_cast<char *>(aligned + size);
+      return reinterpret_cast<void *>(aligned);
+    }
+    void grow(size_t size, size_t alignment) {
+      size_t capacity {std::max(chunk_size, size + alignment + sizeof(std::max_align_t))};
+      chunk * fresh {static_cast<chunk *>(::operator new(capacity))};
+      fresh->next = chunks;
+      chunks = fresh;
+      current = reinterpret_cast<char *>(fresh) + sizeof(std::max_align_t);
+      end = reinterpret_cast<char *>(fresh) + capacity;
+    }
+  public:
+    arena() = default;
+    explicit arena(size_t CHUNK_SIZE) : chunk_size(CHUNK_SIZE) {
+
+    }
+    arena(const arena &) = delete;
+    arena(arena &&) = delete;
+    arena& operator=(const arena &) = delete;
+    arena& operator=(arena &&) = delete;
+    ~arena() {
+      while (chunks) {
+        chunk * next {chunks->next};
+        ::operator delete(chunks);
+        chunks = next;
+      }
+    }
+    void * allocate(size_t size, size_t alignment) {
+      size = std::max(size, sizeof(void *));
+      slab * owner {find_slab(size, alignment)};
+      if (!owner) {
+        owner = ::new (carve(sizeof(slab), alignof(slab))) slab();
+        owner->size = size;
+        owner->alignment = alignment;
+        owner->next = slabs;
+        slabs = owner;
+      }
+      if (owner->free_list) {
+        void * storage {owner->free_list};
+        owner->free_list = *static_cast<void **>(storage);
+        return storage;
+      }
+      return carve(size, alignment);
+    }
+    void deallocate(void * storage, size_t size, size_t alignment) noexcept {
+      size = std::max(size, sizeof(void *));
+      slab * owner {find_slab(size, alignment)};
+      if (!owner) return;
+      *static_cast<void **>(storage) = owner->free_list;
+      owner->free_list = storage;
+    }
+  };
+
+  template <typename T>
+  class arena_allocator {
+  private:
+    std::shared_ptr <arena> resource;
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    arena_allocator() : resource(std::make_shared <arena>()) {
+
+    }
+    explicit arena_allocator(size_t chunk_size) : resource(std::make_shared <arena>(chunk_size)) {
+
+    }
+    explicit arena_allocator(std::shared_ptr <arena> RESOURCE) noexcept : resource(std::move(RESOURCE)) {
+
+    }
+    arena_allocator(const arena_allocator &) = default;
+    arena_allocator& operator=(const arena_allocator &) = default;
+    template <typename V>
+    arena_allocator(const arena_allocator <V> & other) noexcept : resource(other.get_arena()) {
+
+    }
+    T * allocate(size_t n) {
+      return static_cast<T *>(resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T * storage, size_t n) noexcept {
+      resource->deallocate(storage, n * sizeof(T), alignof(T));
+    }
+    const std::shared_ptr <arena> & get_arena() const noexcept {
+      return resource;
+    }
+  };
+
+  template <typename T, typename V>
+  bool operator==(const arena_allocator <T> & lhs, const arena_allocator <V> & rhs) noexcept {
+    return lhs.get_arena() == rhs.get_arena();
+  }
+
+  template <typename T, typename V>
+  bool operator!=(const arena_allocator <T> & lhs, const arena_allocator <V> & rhs) noexcept {
+    return lhs.get_arena() != rhs.get_arena();
+  }
+
+  template <typename Allocator>
+  class releases_on_destruction : public std::false_type {
+
+  };
+
+  template <typename T>
+  class releases_on_destruction <arena_allocator <T> > : public std::true_type {
+
+  };
+}
@@ -5,77 +5,259 @@
 
 #pragma once
 
+#include "arena.hpp"
+#include "frozen_map.hpp"
+#include "thread_pool.hpp"
+
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <queue>
+#include <random>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace forest {
-  template <typename T, typename U>
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> > >
   class avltree {
   private:
+    enum set_operation {
+      UNION,
+      INTERSECTION,
+      DIFFERENCE
+    };
     class avlnode {
     public:
       avlnode() = default;
-      avlnode(const T & KEY, const U & VALUE) :key(KEY), value(VALUE) {
+      template <typename K, typename... Args>
+      avlnode(K && KEY, Args &&... ARGS) : key(std::forward<K>(KEY)), value(std::forward<Args>(ARGS)...) {
 
       }
       avlnode(const avlnode &) = delete;
       avlnode(avlnode &&) = delete;
       avlnode& operator=(const avlnode &) = delete;
       avlnode& operator=(avlnode &&) = delete;
-      ~avlnode() {
-        delete left;
-        delete right;
-      }
+      ~avlnode() = default;
       T key;
       U value;
       friend class avltree;
     private:
-      char balance_factor {0};
+      int height {1};
+      size_t size {1};
       avlnode * parent {nullptr};
       avlnode * left {nullptr};
       avlnode * right {nullptr};
     };
+    using node_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <avlnode>;
+    using node_traits = std::allocator_traits <node_allocator>;
+    Compare compare;
+    node_allocator allocator;
     avlnode * tree_root {nullptr};
-    void pre_order_traversal(const avlnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      handler(root->key, root->value);
-      pre_order_traversal(root->left, handler);
-      pre_order_traversal(root->right, handler);
-    }
-    void in_order_traversal(const avlnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      in_order_traversal(root->left, handler);
-      handler(root->key, root->value);
-      in_order_traversal(root->right, handler);
-    }
-    void post_order_traversal(const avlnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      post_order_traversal(root->left, handler);
-      post_order_traversal(root->right, handler);
-      handler(root->key, root->value);
-    }
-    void breadth_first_traversal(const avlnode * root, void handler(const T & key, const U & value)) noexcept {
-      std::queue <const avlnode *> queue;
-      if (!root) return;
-      queue.push(root);
-      while(!queue.empty()) {
-        avlnode * current {queue.front()};
-        handler(current->key, current->value);
-        queue.pop();
-        if (current->left) queue.push(current->left);
-        if (current->right) queue.push(current->right);
+    avlnode * rightmost {nullptr};
+    void * free_list {nullptr};
+    static constexpr size_t parallel_grain {4096};
+    template <typename... Args>
+    avlnode * create_node(Args &&... args) {
+      avlnode * storage {static_cast<avlnode *>(free_list)};
+      if (storage) {
+        free_list = *static_cast<void **>(free_list);
+      } else {
+        storage = node_traits::allocate(allocator, 1);
+      }
+      try {
+        node_traits::construct(allocator, storage, std::forward<Args>(args)...);
+      } catch (...) {
+        *reinterpret_cast<void **>(storage) = free_list;
+        free_list = storage;
+        throw;
+      }
+      return storage;
+    }
+    void recycle_node(avlnode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      *reinterpret_cast<void **>(n) = free_list;
+      free_list = n;
+    }
+    void destroy_node(avlnode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      node_traits::deallocate(allocator, n, 1);
+    }
+    void destroy_subtree(avlnode * root) noexcept {
+      avlnode * current {root};
+      while (current) {
+        if (current->left) {
+          current = current->left;
+        } else if (current->right) {
+          current = current->right;
+        } else {
+          avlnode * parent {current == root ? nullptr : current->parent};
+          if (parent && parent->left == current) {
+            parent->left = nullptr;
+          } else if (parent) {
+            parent->right = nullptr;
+          }
+          destroy_node(current);
+          current = parent;
+        }
+      }
+    }
+    void release_free_list() noexcept {
+      while (free_list) {
+        void * next {*static_cast<void **>(free_list)};
+        node_traits::deallocate(allocator, static_cast<avlnode *>(free_list), 1);
+        free_list = next;
+      }
+    }
+    void transplant(avlnode * u, avlnode * v) noexcept {
+      if (!u->parent) {
+        tree_root = v;
+      } else if (u == u->parent->left) {
+        u->parent->left = v;
+      } else {
+        u->parent->right = v;
+      }
+      if (v) v->parent = u->parent;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const avlnode * n, std::true_type) {
+      handler(n->key, n->value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const avlnode * n, std::false_type) {
+      return static_cast<bool>(handler(n->key, n->value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const avlnode * n) {
+      return visit(handler, n, std::is_void<decltype(handler(n->key, n->value))>());
+    }
+    avlnode * find(const T & key) {
+      avlnode * candidate {last_not_greater(key)};
+      if (candidate && !compare(candidate->key, key)) return candidate;
+      return nullptr;
+    }
+    avlnode * last_not_greater(const T & key) {
+      avlnode * current {tree_root};
+      avlnode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
       }
+      return candidate;
+    }
+    avlnode * first_not_less(const T & key) {
+      avlnode * current {tree_root};
+      avlnode * candidate {nullptr};
+      while (current) {
+        if (compare(current->key, key)) {
+          current = current->right;
+        } else {
+          candidate = current;
+          current = current->left;
+        }
+      }
+      return candidate;
+    }
+    avlnode * first_greater(const T & key) {
+      avlnode * current {tree_root};
+      avlnode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          candidate = current;
+          current = current->left;
+        } else {
+          current = current->right;
+        }
+      }
+      return candidate;
+    }
+    avlnode * locate(const T & key, avlnode *& parent, bool & left) {
+      return locate(key, parent, left, tree_root);
+    }
+    avlnode * locate(const T & key, avlnode *& parent, bool & left, avlnode * start) {
+      if (rightmost && compare(rightmost->key, key)) {
+        parent = rightmost;
+        left = false;
+        return nullptr;
+      }
+      avlnode * current {start};
+      avlnode * candidate {nullptr};
+      parent = nullptr;
+      left = false;
+      while (current) {
+        parent = current;
+        left = compare(key, current->key);
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(candidate->key, key)) return candidate;
+      return nullptr;
+    }
+    static const avlnode * pre_order_next(const avlnode * n) noexcept {
+      if (n->left) return n->left;
+      if (n->right) return n->right;
+      const avlnode * parent {n->parent};
+      while (parent && (n == parent->right || !parent->right)) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent ? parent->right : nullptr;
+    }
+    static const avlnode * post_order_first(const avlnode * n) noexcept {
+      while (n->left || n->right) n = n->left ? n->left : n->right;
+      return n;
+    }
+    static const avlnode * post_order_next(const avlnode * n) noexcept {
+      const avlnode * parent {n->parent};
+      if (!parent || n == parent->right || !parent->right) return parent;
+      return post_order_first(parent->right);
+    }
+    static const avlnode * next(const avlnode * n) noexcept {
+      if (n->right) {
+        n = n->right;
+        while (n->left) n = n->left;
+        return n;
+      }
+      const avlnode * parent {n->parent};
+      while (parent && n == parent->right) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
+    }
+    static const avlnode * previous(const avlnode * n) noexcept {
+      if (n->left) {
+        n = n->left;
+        while (n->right) n = n->right;
+        return n;
+      }
+      const avlnode * parent {n->parent};
+      while (parent && n == parent->left) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
     }
     size_t height(const avlnode * root) noexcept {
       if (!root) return 0;
-      return std::max(height(root->left), height(root->right)) + 1;
+      return root->height;
     }
     size_t size(const avlnode * root) noexcept {
       if (!root) return 0;
-      return size(root->left) + size(root->right) + 1;
+      return root->size;
     }
     void rotate_right(avlnode * rotation_root) noexcept {
       avlnode * new_root {rotation_root->left};
@@ -94,6 +276,10 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      update_height(rotation_root);
+      update_height(new_root);
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
     }
     void rotate_left(avlnode * rotation_root) noexcept {
       avlnode * new_root {rotation_root->right};
@@ -112,87 +298,784 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      update_height(rotation_root);
+      update_height(new_root);
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
+    }
+    void update_height(avlnode * n) noexcept {
+      n->height = static_cast<int>(std::max(height(n->left), height(n->right))) + 1;
+    }
+    int balance_factor(avlnode * n) noexcept {
+      return static_cast<int>(height(n->right)) - static_cast<int>(height(n->left));
     }
     void fix(avlnode * n) noexcept {
       while (n) {
-        n->balance_factor = (height(n->right) - height(n->left));
-        if (n->balance_factor == -2) {
-          if (n->left->balance_factor == 1) {
+        const int previous_height {n->height};
+        update_height(n);
+        if (balance_factor(n) == -2) {
+          if (balance_factor(n->left) == 1) {
             rotate_left(n->left);
           }
           rotate_right(n);
-        } else if (n->balance_factor == 2) {
-          if (n->right->balance_factor == -1) {
+          n = n->parent;
+        } else if (balance_factor(n) == 2) {
+          if (balance_factor(n->right) == -1) {
             rotate_right(n->right);
           }
           rotate_left(n);
+          n = n->parent;
         }
+        if (n->height == previous_height) break;
         n = n->parent;
       }
     }
+    void link(avlnode * n, avlnode * parent, bool left) {
+      n->parent = parent;
+      if (!parent || (parent == rightmost && !left)) rightmost = n;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      for (avlnode * ancestor {parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size++;
+      }
+      fix(parent);
+    }
+    template <typename K, typename... Args>
+    std::pair <avlnode *, bool> emplace_unique(K && key, Args &&... args) {
+      avlnode * parent {nullptr};
+      bool left {false};
+      avlnode * existing {locate(key, parent, left)};
+      if (existing) return {existing, false};
+      avlnode * n {create_node(std::forward<K>(key), std::forward<Args>(args)...)};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <avlnode *, bool> assign_unique(K && key, V && value) {
+      avlnode * parent {nullptr};
+      bool left {false};
+      avlnode * existing {locate(key, parent, left)};
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      avlnode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <avlnode *, bool> assign_hinted(const avlnode * hint, K && key, V && value) {
+      avlnode * position {const_cast<avlnode *>(hint)};
+      avlnode * parent {nullptr};
+      bool left {false};
+      avlnode * existing {nullptr};
+      if (position && compare(key, position->key)) {
+        avlnode * before {const_cast<avlnode *>(previous(position))};
+        if (!before || compare(before->key, key)) {
+          left = !position->left;
+          parent = left ? position : before;
+        } else {
+          existing = locate(key, parent, left);
+        }
+      } else if (position && !compare(position->key, key)) {
+        existing = position;
+      } else {
+        existing = locate(key, parent, left);
+      }
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      avlnode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.first)) {
+      return element.first;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.key)) {
+      return element.key;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.second)) {
+      return element.second;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.value)) {
+      return element.value;
+    }
+    template <typename ForwardIt>
+    std::vector <ForwardIt> gather(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements;
+      for (ForwardIt it {first}; it != last; ++it) {
+        elements.push_back(it);
+      }
+      auto less = [this](const ForwardIt & lhs, const ForwardIt & rhs) {
+        return compare(key_of(*lhs), key_of(*rhs));
+      };
+      if (!std::is_sorted(elements.begin(), elements.end(), less)) {
+        if (pool) {
+          parallel_stable_sort(elements.begin(), elements.end(), less, *pool);
+        } else {
+          std::stable_sort(elements.begin(), elements.end(), less);
+        }
+      }
+      size_t unique {0};
+      for (size_t i {0}; i < elements.size(); i++) {
+        if (unique && !less(elements[unique - 1], elements[i])) {
+          elements[unique - 1] = elements[i];
+        } else {
+          elements[unique++] = elements[i];
+        }
+      }
+      elements.resize(unique);
+      return elements;
+    }
+    avlnode * climb(avlnode * finger, const T & key) {
+      if (!finger) return tree_root;
+      while (finger->parent && !(finger == finger->parent->left && compare(key, finger->parent->key))) {
+        finger = finger->parent;
+      }
+      return finger;
+    }
+    void relink(const std::vector <avlnode *> & nodes, size_t lo, size_t hi, avlnode * parent, avlnode *& slot) noexcept {
+      if (lo == hi) {
+        slot = nullptr;
+        return;
+      }
+      const size_t middle {lo + (hi - lo) / 2};
+      avlnode * n {nodes[middle]};
+      n->parent = parent;
+      n->size = hi - lo;
+      slot = n;
+      relink(nodes, lo, middle, n, n->left);
+      relink(nodes, middle + 1, hi, n, n->right);
+      n->height = static_cast<int>(std::max(height(n->left), height(n->right))) + 1;
+    }
+    template <typename ForwardIt>
+    void merge(const std::vector <ForwardIt> & elements) {
+      std::vector <avlnode *> nodes;
+      nodes.reserve(size());
+      for (const avlnode * n {begin().node}; n; n = next(n)) {
+        nodes.push_back(const_cast<avlnode *>(n));
+      }
+      std::vector <avlnode *> merged;
+      merged.reserve(nodes.size() + elements.size());
+      std::vector <avlnode *> fresh;
+      fresh.reserve(elements.size());
+      size_t i {0};
+      try {
+        for (const ForwardIt & element : elements) {
+          while (i < nodes.size() && compare(nodes[i]->key, key_of(*element))) {
+            merged.push_back(nodes[i++]);
+          }
+          if (i < nodes.size() && !compare(key_of(*element), nodes[i]->key)) {
+            nodes[i]->value = value_of(*element);
+            merged.push_back(nodes[i++]);
+          } else {
+            fresh.push_back(create_node(key_of(*element), value_of(*element)));
+            merged.push_back(fresh.back());
+          }
+        }
+      } catch (...) {
+        for (avlnode * n : fresh) {
+          recycle_node(n);
+        }
+        throw;
+      }
+      while (i < nodes.size()) {
+        merged.push_back(nodes[i++]);
+      }
+      relink(merged, 0, merged.size(), nullptr, tree_root);
+      rightmost = merged.empty() ? nullptr : merged.back();
+    }
+    template <typename ForwardIt>
+    void build(const std::vector <ForwardIt> & elements, const std::vector <avlnode *> & storage, std::vector <char> & constructed, size_t lo, size_t hi, size_t index, avlnode * parent, avlnode *& slot, thread_pool * pool) {
+      if (lo == hi) return;
+      const size_t middle {lo + (hi - lo) / 2};
+      avlnode * n {storage[index]};
+      node_traits::construct(allocator, n, key_of(*elements[middle]), value_of(*elements[middle]));
+      constructed[index] = true;
+      n->parent = parent;
+      n->size = hi - lo;
+      slot = n;
+      fork(pool, hi - lo, [&] {
+        build(elements, storage, constructed, lo, middle, index + 1, n, n->left, pool);
+      }, [&] {
+        build(elements, storage, constructed, middle + 1, hi, index + 1 + middle - lo, n, n->right, pool);
+      });
+      n->height = static_cast<int>(std::max(height(n->left), height(n->right))) + 1;
+    }
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements {gather(first, last, pool)};
+      std::vector <char> constructed(elements.size());
+      std::vector <avlnode *> storage;
+      storage.reserve(elements.size());
+      clear();
+      try {
+        while (storage.size() < elements.size()) {
+          storage.push_back(node_traits::allocate(allocator, 1));
+        }
+        build(elements, storage, constructed, 0, elements.size(), 0, nullptr, tree_root, pool);
+      } catch (...) {
+        for (size_t i {0}; i < storage.size(); i++) {
+          if (constructed[i]) node_traits::destroy(allocator, storage[i]);
+          node_traits::deallocate(allocator, storage[i], 1);
+        }
+        tree_root = nullptr;
+        throw;
+      }
+      update_rightmost();
+    }
+    void unlink(avlnode * target) noexcept {
+      if (target == rightmost) rightmost = const_cast<avlnode *>(previous(target));
+      avlnode * retrace_root {target->parent};
+      if (!target->left) {
+        transplant(target, target->right);
+      } else if (!target->right) {
+        transplant(target, target->left);
+      } else {
+        avlnode * successor {target->right};
+        while (successor->left) successor = successor->left;
+        if (successor->parent == target) {
+          retrace_root = successor;
+        } else {
+          retrace_root = successor->parent;
+          transplant(successor, successor->right);
+          successor->right = target->right;
+          successor->right->parent = successor;
+        }
+        transplant(target, successor);
+        successor->left = target->left;
+        successor->left->parent = successor;
+        successor->height = target->height;
+        successor->size = target->size;
+      }
+      for (avlnode * ancestor {retrace_root}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size--;
+      }
+      fix(retrace_root);
+    }
+    void join_roots(avlnode * l, avlnode * middle, avlnode * r) noexcept {
+      avlnode * root {nullptr};
+      avlnode * parent {nullptr};
+      if (height(l) > height(r) + 1) {
+        root = l;
+        const size_t limit {height(r) + 1};
+        while (height(l) > limit) {
+          parent = l;
+          l = l->right;
+        }
+        parent->right = middle;
+      } else if (height(r) > height(l) + 1) {
+        root = r;
+        const size_t limit {height(l) + 1};
+        while (height(r) > limit) {
+          parent = r;
+          r = r->left;
+        }
+        parent->left = middle;
+      }
+      middle->parent = parent;
+      middle->left = l;
+      middle->right = r;
+      if (l) l->parent = middle;
+      if (r) r->parent = middle;
+      middle->size = size(l) + size(r) + 1;
+      update_height(middle);
+      if (!parent) {
+        tree_root = middle;
+        return;
+      }
+      const size_t added {middle->size - size(parent->right == middle ? l : r)};
+      for (avlnode * ancestor {parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size += added;
+      }
+      tree_root = root;
+      fix(parent);
+    }
+    void append(avlnode * middle, avltree & right) {
+      if (allocator != right.allocator) {
+        if (middle) link(middle, rightmost, false);
+        for (const avlnode * n {right.begin().node}; n; n = next(n)) {
+          avlnode * source {const_cast<avlnode *>(n)};
+          avlnode * copy {create_node(std::move(source->key), std::move(source->value))};
+          link(copy, rightmost, false);
+        }
+        right.clear();
+        return;
+      }
+      if (!middle) {
+        if (!right.tree_root) return;
+        middle = right.tree_root;
+        while (middle->left) middle = middle->left;
+        right.unlink(middle);
+      }
+      join_roots(tree_root, middle, right.tree_root);
+      rightmost = right.rightmost ? right.rightmost : middle;
+      right.tree_root = nullptr;
+      right.rightmost = nullptr;
+    }
+    static avlnode * detach(avlnode * n) noexcept {
+      if (n) n->parent = nullptr;
+      return n;
+    }
+    avlnode * split_into(avlnode * n, const T & key, avltree & lesser, avltree & greater) {
+      if (!n) return nullptr;
+      if (compare(n->key, key)) {
+        avlnode * found {split_into(n->right, key, lesser, greater)};
+        lesser.join_roots(detach(n->left), n, lesser.tree_root);
+        return found;
+      }
+      if (compare(key, n->key)) {
+        avlnode * found {split_into(n->left, key, lesser, greater)};
+        greater.join_roots(greater.tree_root, n, detach(n->right));
+        return found;
+      }
+      lesser.tree_root = detach(n->left);
+      greater.tree_root = detach(n->right);
+      return n;
+    }
+    void concat_roots(avltree & left, avltree & right) noexcept {
+      if (!right.tree_root) {
+        tree_root = left.tree_root;
+        return;
+      }
+      if (!left.tree_root) {
+        tree_root = right.tree_root;
+        return;
+      }
+      avlnode * middle {right.tree_root};
+      while (middle->left) middle = middle->left;
+      right.unlink(middle);
+      join_roots(left.tree_root, middle, right.tree_root);
+    }
+    template <typename First, typename Second>
+    static void fork(thread_pool * pool, size_t work, First && first, Second && second) {
+      if (pool && work >= parallel_grain) {
+        pool->invoke(first, second);
+      } else {
+        first();
+        second();
+      }
+    }
+    template <typename Handler>
+    static void for_each_subtree(const avlnode * n, Handler & handler, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        const avlnode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          handler(current->key, current->value);
+        }
+        return;
+      }
+      fork(pool, n->size, [&] {
+        if (n->left) for_each_subtree(n->left, handler, pool);
+      }, [&] {
+        handler(n->key, n->value);
+        if (n->right) for_each_subtree(n->right, handler, pool);
+      });
+    }
+    template <typename R, typename Map, typename Combine>
+    static R reduce_subtree(const avlnode * n, const R & identity, Map & map, Combine & combine, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        R result {identity};
+        const avlnode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          result = combine(std::move(result), map(current->key, current->value));
+        }
+        return result;
+      }
+      R left {identity};
+      R right {identity};
+      fork(pool, n->size, [&] {
+        if (n->left) left = reduce_subtree(n->left, identity, map, combine, pool);
+      }, [&] {
+        if (n->right) right = reduce_subtree(n->right, identity, map, combine, pool);
+      });
+      return combine(combine(std::move(left), map(n->key, n->value)), std::move(right));
+    }
+    static void combine(set_operation operation, avltree & a, avltree & b, thread_pool * pool, std::vector <avlnode *> & discarded) {
+      if (!a.tree_root || !b.tree_root) {
+        if (operation == UNION && !a.tree_root) {
+          a.tree_root = b.tree_root;
+        } else if (b.tree_root) {
+          discarded.push_back(b.tree_root);
+        }
+        if (operation == INTERSECTION && a.tree_root) {
+          discarded.push_back(a.tree_root);
+          a.tree_root = nullptr;
+        }
+        b.tree_root = nullptr;
+        return;
+      }
+      const size_t work {a.size(a.tree_root) + b.size(b.tree_root)};
+      avlnode * pivot {b.tree_root};
+      b.tree_root = nullptr;
+      avltree other_left {b.scratch()};
+      avltree other_right {b.scratch()};
+      other_left.tree_root = detach(pivot->left);
+      other_right.tree_root = detach(pivot->right);
+      avltree lesser {a.scratch()};
+      avltree greater {a.scratch()};
+      avlnode * found {a.split_into(a.tree_root, pivot->key, lesser, greater)};
+      a.tree_root = nullptr;
+      std::vector <avlnode *> greater_discarded;
+      fork(pool, work, [&] {
+        combine(operation, lesser, other_left, pool, discarded);
+      }, [&] {
+        combine(operation, greater, other_right, pool, greater_discarded);
+      });
+      discarded.insert(discarded.end(), greater_discarded.begin(), greater_discarded.end());
+      avlnode * middle {operation == UNION ? pivot : operation == INTERSECTION ? found : nullptr};
+      for (avlnode * n : {pivot, found}) {
+        if (!n || n == middle) continue;
+        n->left = nullptr;
+        n->right = nullptr;
+        discarded.push_back(n);
+      }
+      if (middle) {
+        a.join_roots(lesser.tree_root, middle, greater.tree_root);
+      } else {
+        a.concat_roots(lesser, greater);
+      }
+      lesser.tree_root = nullptr;
+      greater.tree_root = nullptr;
+    }
+    void combine_with(set_operation operation, avltree & other, thread_pool * pool) {
+      if (this == &other) {
+        if (operation == DIFFERENCE) clear();
+        return;
+      }
+      if (allocator != other.allocator) {
+        for (const avlnode * n {other.begin().node}; n; n = next(n)) {
+          avlnode * source {const_cast<avlnode *>(n)};
+          if (operation == UNION) {
+            assign_unique(std::move(source->key), std::move(source->value));
+          } else if (operation == DIFFERENCE) {
+            erase(source->key);
+          }
+        }
+        if (operation == INTERSECTION) {
+          for (const avlnode * n {begin().node}; n; ) {
+            const avlnode * following {next(n)};
+            if (!other.find(n->key)) erase(n->key);
+            n = following;
+          }
+        }
+        other.clear();
+        return;
+      }
+      std::vector <avlnode *> discarded;
+      combine(operation, *this, other, pool, discarded);
+      other.rightmost = nullptr;
+      update_rightmost();
+      for (avlnode * n : discarded) {
+        destroy_subtree(n);
+      }
+    }
+    avltree scratch() const {
+      return avltree(compare, Allocator(allocator));
+    }
+    void update_rightmost() noexcept {
+      rightmost = tree_root;
+      while (rightmost && rightmost->right) rightmost = rightmost->right;
+    }
   public:
-    avltree() = default;
-    explicit avltree(std::initializer_list <std::pair <T, U> > list) {
-      for (auto element : list) {
-        insert(element.first, element.second);
+    class iterator {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = avlnode;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const avlnode *;
+      using reference = const avlnode &;
+      iterator() = default;
+      reference operator*() const noexcept {
+        return *node;
+      }
+      pointer operator->() const noexcept {
+        return node;
+      }
+      iterator & operator++() noexcept {
+        node = next(node);
+        return *this;
+      }
+      iterator operator++(int) noexcept {
+        iterator result {*this};
+        ++*this;
+        return result;
+      }
+      iterator & operator--() noexcept {
+        if (node) {
+          node = previous(node);
+        } else {
+          node = tree->rightmost;
+        }
+        return *this;
+      }
+      iterator operator--(int) noexcept {
+        iterator result {*this};
+        --*this;
+        return result;
+      }
+      friend bool operator==(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node == rhs.node;
       }
+      friend bool operator!=(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node != rhs.node;
+      }
+    private:
+      iterator(const avlnode * NODE, const avltree * TREE) : node(NODE), tree(TREE) {
+
+      }
+      const avlnode * node {nullptr};
+      const avltree * tree {nullptr};
+      friend class avltree;
+    };
+    using const_iterator = iterator;
+    using reverse_iterator = std::reverse_iterator <iterator>;
+    using const_reverse_iterator = reverse_iterator;
+    avltree() = default;
+    explicit avltree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+
+    }
+    explicit avltree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    avltree(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(first, last);
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    avltree(ForwardIt first, ForwardIt last, thread_pool & pool, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(first, last, pool);
+    }
+    explicit avltree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(list.begin(), list.end());
     }
     avltree(const avltree &) = delete;
-    avltree(avltree &&) = delete;
+    avltree(avltree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), tree_root(other.tree_root), rightmost(other.rightmost), free_list(other.free_list) {
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+    }
     avltree& operator=(const avltree &) = delete;
-    avltree& operator=(avltree &&) = delete;
+    avltree& operator=(avltree && other) {
+      if (this == &other) return *this;
+      clear();
+      compare = std::move(other.compare);
+      if (node_traits::propagate_on_container_move_assignment::value) {
+        allocator = std::move(other.allocator);
+      } else if (allocator != other.allocator) {
+        for (const avlnode * n {other.begin().node}; n; n = next(n)) {
+          avlnode * source {const_cast<avlnode *>(n)};
+          emplace_unique(std::move(source->key), std::move(source->value));
+        }
+        other.clear();
+        return *this;
+      }
+      tree_root = other.tree_root;
+      rightmost = other.rightmost;
+      free_list = other.free_list;
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+      return *this;
+    }
     ~avltree() {
-      delete tree_root;
+      if (!releases_on_destruction <node_allocator>::value || !std::is_trivially_destructible <avlnode>::value) {
+        clear();
+      }
     }
-    void pre_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      pre_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last) {
+      assign(first, last, nullptr);
     }
-    void in_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      in_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool & pool) {
+      assign(first, last, &pool);
     }
-    void post_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      post_order_traversal(tree_root, handler);
+    template <typename Handler>
+    void pre_order_traversal(Handler handler) {
+      for (const avlnode * current {tree_root}; current; current = pre_order_next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void breadth_first_traversal(void handler(const T & key, const U & value)) noexcept {
-      breadth_first_traversal(tree_root, handler);
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      for (const avlnode * current {begin().node}; current; current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void insert(const T & key, const U & value) noexcept {
-      avlnode * current {tree_root};
-      avlnode * parent {nullptr};
-      while (current) {
-        parent = current;
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
-        } else if (key == current->key) {
-          current->value = value;
-          return;
-        }
+    template <typename Handler>
+    void post_order_traversal(Handler handler) {
+      if (!tree_root) return;
+      for (const avlnode * current {post_order_first(tree_root)}; current; current = post_order_next(current)) {
+        if (!visit(handler, current)) return;
       }
-      current = new avlnode(key, value);
-      current->parent = parent;
-      if(!parent) {
-        tree_root = current;
-      } else if (current->key > parent->key) {
-        parent->right = current;
-      } else if (current->key < parent->key) {
-        parent->left = current;
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <const avlnode *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        const avlnode * current {queue.front()};
+        if (!visit(handler, current)) return;
+        queue.pop();
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
       }
-      fix(current);
     }
-    const avlnode * search(const T & key) noexcept {
-      avlnode * current {tree_root};
-      while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
+    template <typename Handler>
+    void parallel_for_each(Handler handler, thread_pool & pool) const {
+      if (tree_root) for_each_subtree(tree_root, handler, &pool);
+    }
+    template <typename R, typename Map, typename Combine>
+    R parallel_reduce(const R & identity, Map map, Combine combine, thread_pool & pool) const {
+      if (!tree_root) return identity;
+      return reduce_subtree(tree_root, identity, map, combine, &pool);
+    }
+    std::pair <iterator, bool> insert(const T & key, const U & value) {
+      return insert_or_assign(key, value);
+    }
+    std::pair <iterator, bool> insert(const T & key, U && value) {
+      return insert_or_assign(key, std::move(value));
+    }
+    std::pair <iterator, bool> insert(T && key, const U & value) {
+      return insert_or_assign(std::move(key), value);
+    }
+    std::pair <iterator, bool> insert(T && key, U && value) {
+      return insert_or_assign(std::move(key), std::move(value));
+    }
+    template <typename V>
+    iterator insert(iterator hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint.node, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(iterator hint, T && key, V && value) {
+      return iterator(assign_hinted(hint.node, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const avlnode * hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const avlnode * hint, T && key, V && value) {
+      return iterator(assign_hinted(hint, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename ForwardIt>
+    void insert_batch(ForwardIt first, ForwardIt last) {
+      std::vector <ForwardIt> elements {gather(first, last, nullptr)};
+      if (elements.size() >= size()) {
+        merge(elements);
+        return;
+      }
+      avlnode * finger {nullptr};
+      for (const ForwardIt & element : elements) {
+        avlnode * parent {nullptr};
+        bool left {false};
+        avlnode * existing {locate(key_of(*element), parent, left, climb(finger, key_of(*element)))};
+        if (existing) {
+          existing->value = value_of(*element);
+          finger = existing;
         } else {
-          return current;
+          finger = create_node(key_of(*element), value_of(*element));
+          link(finger, parent, left);
         }
       }
-      return nullptr;
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(const T & key, V && value) {
+      std::pair <avlnode *, bool> result {assign_unique(key, std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(T && key, V && value) {
+      std::pair <avlnode *, bool> result {assign_unique(std::move(key), std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(const T & key, Args &&... args) {
+      std::pair <avlnode *, bool> result {emplace_unique(key, std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(T && key, Args &&... args) {
+      std::pair <avlnode *, bool> result {emplace_unique(std::move(key), std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> emplace(Args &&... args) {
+      avlnode * n {create_node(std::forward<Args>(args)...)};
+      avlnode * parent {nullptr};
+      bool left {false};
+      avlnode * existing {locate(n->key, parent, left)};
+      if (existing) {
+        recycle_node(n);
+        return {iterator(existing, this), false};
+      }
+      link(n, parent, left);
+      return {iterator(n, this), true};
+    }
+    size_t erase(const T & key) {
+      avlnode * target {find(key)};
+      if (!target) return 0;
+      unlink(target);
+      recycle_node(target);
+      return 1;
+    }
+    std::pair <avltree, avltree> split(const T & key) {
+      std::pair <avltree, avltree> result {scratch(), scratch()};
+      avlnode * found {split_into(tree_root, key, result.first, result.second)};
+      if (found) result.second.join_roots(nullptr, found, result.second.tree_root);
+      result.first.update_rightmost();
+      result.second.update_rightmost();
+      tree_root = nullptr;
+      rightmost = nullptr;
+      return result;
+    }
+    template <typename V>
+    static avltree join(avltree && left, const T & key, V && value, avltree && right) {
+      avlnode * middle {left.create_node(key, std::forward<V>(value))};
+      avltree result {std::move(left)};
+      result.append(middle, right);
+      return result;
+    }
+    static avltree concat(avltree && left, avltree && right) {
+      avltree result {std::move(left)};
+      result.append(nullptr, right);
+      return result;
+    }
+    void union_with(avltree && other) {
+      combine_with(UNION, other, nullptr);
+    }
+    void union_with(avltree && other, thread_pool & pool) {
+      combine_with(UNION, other, &pool);
+    }
+    void intersect_with(avltree && other) {
+      combine_with(INTERSECTION, other, nullptr);
+    }
+    void intersect_with(avltree && other, thread_pool & pool) {
+      combine_with(INTERSECTION, other, &pool);
+    }
+    void difference(avltree && other) {
+      combine_with(DIFFERENCE, other, nullptr);
+    }
+    void difference(avltree && other, thread_pool & pool) {
+      combine_with(DIFFERENCE, other, &pool);
+    }
+    const avlnode * search(const T & key) {
+      return find(key);
     }
     const avlnode * minimum() noexcept {
       avlnode * current {tree_root};
@@ -201,64 +1084,149 @@ namespace forest {
       return current;
     }
     const avlnode * maximum() noexcept {
-      avlnode * current {tree_root};
+      return rightmost;
+    }
+    const avlnode * successor(const T & key) {
+      avlnode * current {find(key)};
       if (!current) return nullptr;
-      while(current->right) current = current->right;
-      return current;
+      return next(current);
+    }
+    const avlnode * predecessor(const T & key) {
+      avlnode * current {find(key)};
+      if (!current) return nullptr;
+      return previous(current);
     }
-    const avlnode * successor(const T & key) noexcept {
+    const avlnode * floor(const T & key) {
+      return last_not_greater(key);
+    }
+    const avlnode * ceiling(const T & key) {
+      return first_not_less(key);
+    }
+    iterator lower_bound(const T & key) {
+      return iterator(first_not_less(key), this);
+    }
+    iterator upper_bound(const T & key) {
+      return iterator(first_greater(key), this);
+    }
+    std::pair <iterator, iterator> equal_range(const T & key) {
+      const avlnode * first {first_not_less(key)};
+      const avlnode * last {first && !compare(key, first->key) ? next(first) : first};
+      return {iterator(first, this), iterator(last, this)};
+    }
+    template <typename Handler>
+    void for_each_in_range(const T & lo, const T & hi, Handler handler) {
+      for (const avlnode * current {first_not_less(lo)}; current && compare(current->key, hi); current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
+    }
+    size_t rank(const T & key) {
+      size_t result {0};
       avlnode * current {tree_root};
       while (current) {
-        if (key > current->key) {
+        if (compare(current->key, key)) {
+          result += size(current->left) + 1;
           current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
         } else {
-          if (current->right) {
-            current = current->right;
-            while(current->left) current = current->left;
-            return current;
-          }
-          avlnode * parent {current->parent};
-          while (parent && current == parent->right) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          current = current->left;
         }
       }
-      return nullptr;
+      return result;
     }
-    const avlnode * predecessor(const T & key) noexcept {
+    const avlnode * select(size_t index) {
       avlnode * current {tree_root};
       while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
+        size_t left_size {size(current->left)};
+        if (index < left_size) {
           current = current->left;
+        } else if (index > left_size) {
+          index -= left_size + 1;
+          current = current->right;
         } else {
-          if (current->left) {
-            current = current->left;
-            while(current->right) current = current->right;
-            return current;
-          }
-          avlnode * parent {current->parent};
-          while (parent && current == parent->left) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          return current;
         }
       }
       return nullptr;
     }
+    size_t count_range(const T & lo, const T & hi) {
+      size_t lo_rank {rank(lo)};
+      size_t hi_rank {rank(hi)};
+      return hi_rank > lo_rank ? hi_rank - lo_rank : 0;
+    }
+    const avlnode * percentile(double p) {
+      if (!tree_root) return nullptr;
+      size_t n {size(tree_root)};
+      size_t nearest_rank {static_cast<size_t>(std::ceil(std::min(std::max(p, 0.0), 100.0) / 100.0 * n))};
+      return select(nearest_rank ? std::min(nearest_rank, n) - 1 : 0);
+    }
+    template <typename Generator>
+    const avlnode * sample(Generator & generator) {
+      if (!tree_root) return nullptr;
+      std::uniform_int_distribution <size_t> distribution(0, size(tree_root) - 1);
+      return select(distribution(generator));
+    }
+    iterator begin() const noexcept {
+      const avlnode * current {tree_root};
+      if (current) {
+        while (current->left) current = current->left;
+      }
+      return iterator(current, this);
+    }
+    iterator end() const noexcept {
+      return iterator(nullptr, this);
+    }
+    iterator cbegin() const noexcept {
+      return begin();
+    }
+    iterator cend() const noexcept {
+      return end();
+    }
+    reverse_iterator rbegin() const noexcept {
+      return reverse_iterator(end());
+    }
+    reverse_iterator rend() const noexcept {
+      return reverse_iterator(begin());
+    }
+    reverse_iterator crbegin() const noexcept {
+      return rbegin();
+    }
+    reverse_iterator crend() const noexcept {
+      return rend();
+    }
     size_t height() noexcept {
       return height(tree_root);
     }
     size_t size() noexcept {
       return size(tree_root);
     }
-    bool empty() noexcept {
+    void clear() noexcept {
+      destroy_subtree(tree_root);
+      tree_root = nullptr;
+      rightmost = nullptr;
+      release_free_list();
+    }
+    frozen_map <T, U, Compare> freeze() const {
+      return frozen_map <T, U, Compare>(begin(), end(), compare);
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return Allocator(allocator);
+    }
+    void swap(avltree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      if (node_traits::propagate_on_container_swap::value) {
+        swap(allocator, other.allocator);
+      }
+      swap(tree_root, other.tree_root);
+      swap(rightmost, other.rightmost);
+      swap(free_list, other.free_list);
+    }
+    friend void swap(avltree & lhs, avltree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
       return !tree_root;
     }
     const avlnode * root() noexcept {
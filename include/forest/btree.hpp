@@ -0,0 +1,578 @@
+/**
+ * @file btree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <queue>
+#include <type_traits>
+#include <utility>
+
+namespace forest {
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> >, size_t Fanout = std::max <size_t>(4, std::min <size_t>(64, 256 / sizeof(T)) & ~size_t {1})>
+  class btree {
+    static_assert(Fanout >= 4 && Fanout % 2 == 0, "Fanout must be an even number of at least 4");
+  private:
+    static constexpr size_t max_keys {Fanout - 1};
+    static constexpr size_t min_keys {Fanout / 2 - 1};
+    class btinner;
+    class btnode {
+    public:
+      btnode() = default;
+      btnode(const btnode &) = delete;
+      btnode(btnode &&) = delete;
+      btnode& operator=(const btnode &) = delete;
+      btnode& operator=(btnode &&) = delete;
+      ~btnode() = default;
+      btinner * parent {nullptr};
+      size_t position {0};
+      size_t count {0};
+      bool leaf {true};
+      typename std::aligned_storage <sizeof(T), alignof(T)>::type keys[max_keys];
+      typename std::aligned_storage <sizeof(U), alignof(U)>::type values[max_keys];
+    };
+    class btinner : public btnode {
+    public:
+      btinner() {
+        this->leaf = false;
+      }
+      btnode * children[Fanout] {};
+    };
+  public:
+    class element {
+    public:
+      const T & key;
+      const U & value;
+      const element * operator->() const noexcept {
+        return this;
+      }
+    };
+    class element_pointer {
+    public:
+      element_pointer() = default;
+      element_pointer(std::nullptr_t) noexcept {
+
+      }
+      element operator*() const noexcept {
+        return {btree::keys(node)[index], btree::values(node)[index]};
+      }
+      element operator->() const noexcept {
+        return **this;
+      }
+      explicit operator bool() const noexcept {
+        return node != nullptr;
+      }
+      friend bool operator==(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return lhs.node == rhs.node && lhs.index == rhs.index;
+      }
+      friend bool operator!=(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return !(lhs == rhs);
+      }
+      friend bool operator==(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return !lhs.node;
+      }
+      friend bool operator!=(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return lhs.node;
+      }
+      friend bool operator==(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return !rhs.node;
+      }
+      friend bool operator!=(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return rhs.node;
+      }
+    private:
+      element_pointer(const btnode * NODE, size_t INDEX) noexcept : node(NODE), index(INDEX) {
+
+      }
+      const btnode * node {nullptr};
+      size_t index {0};
+      friend class btree;
+    };
+  private:
+    using leaf_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <btnode>;
+    using leaf_traits = std::allocator_traits <leaf_allocator>;
+    using inner_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <btinner>;
+    using inner_traits = std::allocator_traits <inner_allocator>;
+    Compare compare;
+    Allocator allocator;
+    btnode * tree_root {nullptr};
+    size_t element_count {0};
+    static T * keys(btnode * n) noexcept {
+      return reinterpret_cast<T *>(n->keys);
+    }
+    static const T * keys(const btnode * n) noexcept {
+      return reinterpret_cast<const T *>(n->keys);
+    }
+    static U * values(btnode * n) noexcept {
+      return reinterpret_cast<U *>(n->values);
+    }
+    static const U * values(const btnode * n) noexcept {
+      return reinterpret_cast<const U *>(n->values);
+    }
+    static btnode * child(const btnode * n, size_t i) noexcept {
+      return static_cast<const btinner *>(n)->children[i];
+    }
+    static void set_child(btnode * n, size_t i, btnode * c) noexcept {
+      static_cast<btinner *>(n)->children[i] = c;
+      c->parent = static_cast<btinner *>(n);
+      c->position = i;
+    }
+    btnode * create_node(bool leaf) {
+      if (leaf) {
+        leaf_allocator a(allocator);
+        btnode * n {leaf_traits::allocate(a, 1)};
+        leaf_traits::construct(a, n);
+        return n;
+      }
+      inner_allocator a(allocator);
+      btinner * n {inner_traits::allocate(a, 1)};
+      inner_traits::construct(a, n);
+      return n;
+    }
+    void destroy_node(btnode * n) noexcept {
+      for (size_t i {0}; i < n->count; i++) {
+        keys(n)[i].~T();
+        values(n)[i].~U();
+      }
+      if (n->leaf) {
+        leaf_allocator a(allocator);
+        leaf_traits::destroy(a, n);
+        leaf_traits::deallocate(a, n, 1);
+      } else {
+        inner_allocator a(allocator);
+        btinner * inner {static_cast<btinner *>(n)};
+        inner_traits::destroy(a, inner);
+        inner_traits::deallocate(a, inner, 1);
+      }
+    }
+    void destroy_subtree(btnode * n) noexcept {
+      if (!n) return;
+      if (!n->leaf) {
+        for (size_t i {0}; i <= n->count; i++) {
+          destroy_subtree(child(n, i));
+        }
+      }
+      destroy_node(n);
+    }
+    template <typename K, typename V>
+    static void construct(btnode * n, size_t i, K && key, V && value) {
+      ::new (static_cast<void *>(keys(n) + i)) T(std::forward<K>(key));
+      try {
+        ::new (static_cast<void *>(values(n) + i)) U(std::forward<V>(value));
+      } catch (...) {
+        keys(n)[i].~T();
+        throw;
+      }
+    }
+    static void relocate(btnode * to, size_t j, btnode * from, size_t i) noexcept {
+      ::new (static_cast<void *>(keys(to) + j)) T(std::move(keys(from)[i]));
+      keys(from)[i].~T();
+      ::new (static_cast<void *>(values(to) + j)) U(std::move(values(from)[i]));
+      values(from)[i].~U();
+    }
+    static void destroy_element(btnode * n, size_t i) noexcept {
+      keys(n)[i].~T();
+      values(n)[i].~U();
+    }
+    size_t lower_index(const btnode * n, const T & key) const {
+      return std::lower_bound(keys(n), keys(n) + n->count, key, compare) - keys(n);
+    }
+    std::pair <btnode *, size_t> locate(const T & key, bool & found) const {
+      btnode * current {tree_root};
+      while (true) {
+        size_t i {lower_index(current, key)};
+        if (i < current->count && !compare(key, keys(current)[i])) {
+          found = true;
+          return {current, i};
+        }
+        if (current->leaf) {
+          found = false;
+          return {current, i};
+        }
+        current = child(current, i);
+      }
+    }
+    void split(btnode * n) {
+      btnode * sibling {create_node(n->leaf)};
+      if (!n->parent) {
+        btnode * root;
+        try {
+          root = create_node(false);
+        } catch (...) {
+          destroy_node(sibling);
+          throw;
+        }
+        set_child(root, 0, n);
+        tree_root = root;
+      } else if (n->parent->count == max_keys) {
+        try {
+          split(n->parent);
+        } catch (...) {
+          destroy_node(sibling);
+          throw;
+        }
+      }
+      btnode * parent {n->parent};
+      const size_t index {n->position};
+      const size_t middle {max_keys / 2};
+      for (size_t i {middle + 1}; i < max_keys; i++) {
+        relocate(sibling, i - middle - 1, n, i);
+      }
+      if (!n->leaf) {
+        for (size_t i {middle + 1}; i <= max_keys; i++) {
+          set_child(sibling, i - middle - 1, child(n, i));
+        }
+      }
+      sibling->count = max_keys - middle - 1;
+      for (size_t i {parent->count}; i > index; i--) {
+        relocate(parent, i, parent, i - 1);
+        set_child(parent, i + 1, child(parent, i));
+      }
+      relocate(parent, index, n, middle);
+      set_child(parent, index + 1, sibling);
+      n->count = middle;
+      parent->count++;
+    }
+    template <typename K, typename V>
+    std::pair <element_pointer, bool> assign_unique(K && key, V && value) {
+      if (!tree_root) tree_root = create_node(true);
+      bool found;
+      std::pair <btnode *, size_t> position {locate(key, found)};
+      btnode * n {position.first};
+      size_t i {position.second};
+      if (found) {
+        values(n)[i] = std::forward<V>(value);
+        return {element_pointer(n, i), false};
+      }
+      if (n->count == max_keys) {
+        split(n);
+        if (i > n->count) {
+          i -= n->count + 1;
+          n = child(n->parent, n->position + 1);
+        }
+      }
+      for (size_t j {n->count}; j > i; j--) {
+        relocate(n, j, n, j - 1);
+      }
+      try {
+        construct(n, i, std::forward<K>(key), std::forward<V>(value));
+      } catch (...) {
+        for (size_t j {i}; j < n->count; j++) {
+          relocate(n, j, n, j + 1);
+        }
+        if (!element_count) {
+          destroy_node(tree_root);
+          tree_root = nullptr;
+        }
+        throw;
+      }
+      n->count++;
+      element_count++;
+      return {element_pointer(n, i), true};
+    }
+    static void rotate_right(btnode * parent, size_t index) noexcept {
+      btnode * n {child(parent, index)};
+      btnode * left {child(parent, index - 1)};
+      for (size_t i {n->count}; i > 0; i--) {
+        relocate(n, i, n, i - 1);
+      }
+      if (!n->leaf) {
+        for (size_t i {n->count + 1}; i > 0; i--) {
+          set_child(n, i, child(n, i - 1));
+        }
+        set_child(n, 0, child(left, left->count));
+      }
+      relocate(n, 0, parent, index - 1);
+      relocate(parent, index - 1, left, left->count - 1);
+      n->count++;
+      left->count--;
+    }
+    static void rotate_left(btnode * parent, size_t index) noexcept {
+      btnode * n {child(parent, index)};
+      btnode * right {child(parent, index + 1)};
+      relocate(n, n->count, parent, index);
+      if (!n->leaf) set_child(n, n->count + 1, child(right, 0));
+      relocate(parent, index, right, 0);
+      for (size_t i {1}; i < right->count; i++) {
+        relocate(right, i - 1, right, i);
+      }
+      if (!right->leaf) {
+        for (size_t i {1}; i <= right->count; i++) {
+          set_child(right, i - 1, child(right, i));
+        }
+      }
+      n->count++;
+      right->count--;
+    }
+    void merge_children(btnode * parent, size_t index) noexcept {
+      btnode * left {child(parent, index)};
+      btnode * right {child(parent, index + 1)};
+      relocate(left, left->count, parent, index);
+      for (size_t i {0}; i < right->count; i++) {
+        relocate(left, left->count + 1 + i, right, i);
+      }
+      if (!left->leaf) {
+        for (size_t i {0}; i <= right->count; i++) {
+          set_child(left, left->count + 1 + i, child(right, i));
+        }
+      }
+      left->count += right->count + 1;
+      for (size_t i {index + 1}; i < parent->count; i++) {
+        relocate(parent, i - 1, parent, i);
+        set_child(parent, i, child(parent, i + 1));
+      }
+      parent->count--;
+      right->count = 0;
+      destroy_node(right);
+    }
+    void erase_at(btnode * n, size_t i) noexcept {
+      destroy_element(n, i);
+      if (!n->leaf) {
+        btnode * leaf {child(n, i)};
+        while (!leaf->leaf) leaf = child(leaf, leaf->count);
+        relocate(n, i, leaf, leaf->count - 1);
+        n = leaf;
+      } else {
+        for (size_t j {i + 1}; j < n->count; j++) {
+          relocate(n, j - 1, n, j);
+        }
+      }
+      n->count--;
+      element_count--;
+      while (n->parent && n->count < min_keys) {
+        btnode * parent {n->parent};
+        const size_t index {n->position};
+        if (index > 0 && child(parent, index - 1)->count > min_keys) {
+          rotate_right(parent, index);
+          return;
+        }
+        if (index < parent->count && child(parent, index + 1)->count > min_keys) {
+          rotate_left(parent, index);
+          return;
+        }
+        merge_children(parent, index > 0 ? index - 1 : index);
+        n = parent;
+      }
+      if (tree_root->count == 0) {
+        btnode * root {tree_root};
+        tree_root = root->leaf ? nullptr : child(root, 0);
+        if (tree_root) tree_root->parent = nullptr;
+        destroy_node(root);
+      }
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const btnode * n, size_t i, std::true_type) {
+      handler(keys(n)[i], values(n)[i]);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const btnode * n, size_t i, std::false_type) {
+      return static_cast<bool>(handler(keys(n)[i], values(n)[i]));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const btnode * n, size_t i) {
+      return visit(handler, n, i, std::is_void<decltype(handler(keys(n)[i], values(n)[i]))>());
+    }
+    template <typename Handler>
+    static bool in_order(Handler & handler, const btnode * n) {
+      for (size_t i {0}; i < n->count; i++) {
+        if (!n->leaf && !in_order(handler, child(n, i))) return false;
+        if (!visit(handler, n, i)) return false;
+      }
+      return n->leaf || in_order(handler, child(n, n->count));
+    }
+    template <typename Handler>
+    static bool pre_order(Handler & handler, const btnode * n) {
+      for (size_t i {0}; i < n->count; i++) {
+        if (!visit(handler, n, i)) return false;
+      }
+      if (n->leaf) return true;
+      for (size_t i {0}; i <= n->count; i++) {
+        if (!pre_order(handler, child(n, i))) return false;
+      }
+      return true;
+    }
+    template <typename Handler>
+    static bool post_order(Handler & handler, const btnode * n) {
+      if (!n->leaf) {
+        for (size_t i {0}; i <= n->count; i++) {
+          if (!post_order(handler, child(n, i))) return false;
+        }
+      }
+      for (size_t i {0}; i < n->count; i++) {
+        if (!visit(handler, n, i)) return false;
+      }
+      return true;
+    }
+  public:
+    btree() = default;
+    explicit btree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+
+    }
+    explicit btree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    btree(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      try {
+        for (; first != last; ++first) {
+          insert(first->first, first->second);
+        }
+      } catch (...) {
+        clear();
+        throw;
+      }
+    }
+    explicit btree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : btree(list.begin(), list.end(), COMPARE, ALLOCATOR) {
+
+    }
+    btree(const btree &) = delete;
+    btree(btree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), tree_root(other.tree_root), element_count(other.element_count) {
+      other.tree_root = nullptr;
+      other.element_count = 0;
+    }
+    btree& operator=(const btree &) = delete;
+    btree& operator=(btree && other) {
+      if (this == &other) return *this;
+      clear();
+      compare = std::move(other.compare);
+      if (std::allocator_traits <Allocator>::propagate_on_container_move_assignment::value) {
+        allocator = std::move(other.allocator);
+      } else if (allocator != other.allocator) {
+        other.in_order_traversal([this](const T & key, const U & value) {
+          insert(std::move(const_cast<T &>(key)), std::move(const_cast<U &>(value)));
+        });
+        other.clear();
+        return *this;
+      }
+      tree_root = other.tree_root;
+      element_count = other.element_count;
+      other.tree_root = nullptr;
+      other.element_count = 0;
+      return *this;
+    }
+    ~btree() {
+      clear();
+    }
+    template <typename Handler>
+    void pre_order_traversal(Handler handler) {
+      if (tree_root) pre_order(handler, tree_root);
+    }
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      if (tree_root) in_order(handler, tree_root);
+    }
+    template <typename Handler>
+    void post_order_traversal(Handler handler) {
+      if (tree_root) post_order(handler, tree_root);
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <const btnode *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        const btnode * current {queue.front()};
+        queue.pop();
+        for (size_t i {0}; i < current->count; i++) {
+          if (!visit(handler, current, i)) return;
+        }
+        if (current->leaf) continue;
+        for (size_t i {0}; i <= current->count; i++) {
+          queue.push(child(current, i));
+        }
+      }
+    }
+    std::pair <element_pointer, bool> insert(const T & key, const U & value) {
+      return assign_unique(key, value);
+    }
+    std::pair <element_pointer, bool> insert(const T & key, U && value) {
+      return assign_unique(key, std::move(value));
+    }
+    std::pair <element_pointer, bool> insert(T && key, const U & value) {
+      return assign_unique(std::move(key), value);
+    }
+    std::pair <element_pointer, bool> insert(T && key, U && value) {
+      return assign_unique(std::move(key), std::move(value));
+    }
+    template <typename V>
+    std::pair <element_pointer, bool> insert_or_assign(const T & key, V && value) {
+      return assign_unique(key, std::forward<V>(value));
+    }
+    template <typename V>
+    std::pair <element_pointer, bool> insert_or_assign(T && key, V && value) {
+      return assign_unique(std::move(key), std::forward<V>(value));
+    }
+    size_t erase(const T & key) {
+      if (!tree_root) return 0;
+      bool found;
+      std::pair <btnode *, size_t> position {locate(key, found)};
+      if (!found) return 0;
+      erase_at(position.first, position.second);
+      return 1;
+    }
+    element_pointer search(const T & key) const {
+      if (!tree_root) return nullptr;
+      bool found;
+      std::pair <btnode *, size_t> position {locate(key, found)};
+      if (!found) return nullptr;
+      return element_pointer(position.first, position.second);
+    }
+    element_pointer minimum() const noexcept {
+      const btnode * current {tree_root};
+      if (!current) return nullptr;
+      while (!current->leaf) current = child(current, 0);
+      return element_pointer(current, 0);
+    }
+    element_pointer maximum() const noexcept {
+      const btnode * current {tree_root};
+      if (!current) return nullptr;
+      while (!current->leaf) current = child(current, current->count);
+      return element_pointer(current, current->count - 1);
+    }
+    size_t height() const noexcept {
+      size_t result {0};
+      for (const btnode * current {tree_root}; current; current = current->leaf ? nullptr : child(current, 0)) {
+        result++;
+      }
+      return result;
+    }
+    size_t size() const noexcept {
+      return element_count;
+    }
+    void clear() noexcept {
+      destroy_subtree(tree_root);
+      tree_root = nullptr;
+      element_count = 0;
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return allocator;
+    }
+    void swap(btree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      if (std::allocator_traits <Allocator>::propagate_on_container_swap::value) {
+        swap(allocator, other.allocator);
+      }
+      swap(tree_root, other.tree_root);
+      swap(element_count, other.element_count);
+    }
+    friend void swap(btree & lhs, btree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return element_count == 0;
+    }
+  };
+}
@@ -0,0 +1,677 @@
+/**
+ * @file compact_rbtree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace forest {
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> > >
+  class compact_rbtree {
+  private:
+    static constexpr uint32_t null {0x7FFFFFFF};
+    static constexpr uint32_t red {0x80000000};
+    static constexpr uint32_t vacant {0xFFFFFFFF};
+    class crbnode {
+    public:
+      typename std::aligned_storage <sizeof(T), alignof(T)>::type key;
+      typename std::aligned_storage <sizeof(U), alignof(U)>::type value;
+      uint32_t left;
+      uint32_t right;
+      uint32_t parent;
+    };
+  public:
+    class element {
+    public:
+      const T & key;
+      const U & value;
+      const element * operator->() const noexcept {
+        return this;
+      }
+    };
+    class element_pointer {
+    public:
+      element_pointer() = default;
+      element_pointer(std::nullptr_t) noexcept {
+
+      }
+      element operator*() const noexcept {
+        return {tree->key(index), tree->value(index)};
+      }
+      element operator->() const noexcept {
+        return **this;
+      }
+      explicit operator bool() const noexcept {
+        return tree != nullptr;
+      }
+      friend bool operator==(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return lhs.tree == rhs.tree && lhs.index == rhs.index;
+      }
+      friend bool operator!=(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return !(lhs == rhs);
+      }
+      friend bool operator==(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return !lhs.tree;
+      }
+      friend bool operator!=(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return lhs.tree;
+      }
+      friend bool operator==(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return !rhs.tree;
+      }
+      friend bool operator!=(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return rhs.tree;
+      }
+    private:
+      element_pointer(const compact_rbtree * TREE, uint32_t INDEX) noexcept : tree(TREE), index(INDEX) {
+
+      }
+      const compact_rbtree * tree {nullptr};
+      uint32_t index {0};
+      friend class compact_rbtree;
+    };
+  private:
+    using node_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <crbnode>;
+    using node_traits = std::allocator_traits <node_allocator>;
+    Compare compare;
+    node_allocator allocator;
+    crbnode * nodes {nullptr};
+    uint32_t capacity {0};
+    uint32_t used {0};
+    uint32_t free_list {null};
+    uint32_t tree_root {null};
+    size_t element_count {0};
+    T & key(uint32_t n) noexcept {
+      return *reinterpret_cast<T *>(&nodes[n].key);
+    }
+    const T & key(uint32_t n) const noexcept {
+      return *reinterpret_cast<const T *>(&nodes[n].key);
+    }
+    U & value(uint32_t n) noexcept {
+      return *reinterpret_cast<U *>(&nodes[n].value);
+    }
+    const U & value(uint32_t n) const noexcept {
+      return *reinterpret_cast<const U *>(&nodes[n].value);
+    }
+    uint32_t parent(uint32_t n) const noexcept {
+      return nodes[n].parent & null;
+    }
+    void set_parent(uint32_t n, uint32_t p) noexcept {
+      nodes[n].parent = (nodes[n].parent & red) | p;
+    }
+    bool is_red(uint32_t n) const noexcept {
+      return n != null && (nodes[n].parent & red);
+    }
+    void paint(uint32_t n, bool to_red) noexcept {
+      nodes[n].parent = to_red ? (nodes[n].parent | red) : (nodes[n].parent & null);
+    }
+    template <typename K, typename V>
+    static void construct(crbnode * storage, uint32_t n, K && key, V && value) {
+      ::new (static_cast<void *>(&storage[n].key)) T(std::forward<K>(key));
+      try {
+        ::new (static_cast<void *>(&storage[n].value)) U(std::forward<V>(value));
+      } catch (...) {
+        reinterpret_cast<T *>(&storage[n].key)->~T();
+        throw;
+      }
+    }
+    static void destroy_element(crbnode * storage, uint32_t n) noexcept {
+      reinterpret_cast<T *>(&storage[n].key)->~T();
+      reinterpret_cast<U *>(&storage[n].value)->~U();
+    }
+    void relocate(crbnode * storage) {
+      uint32_t i {0};
+      try {
+        for (; i < used; i++) {
+          ::new (static_cast<void *>(storage + i)) crbnode;
+          if (nodes[i].right != vacant) {
+            construct(storage, i, std::move_if_noexcept(key(i)), std::move_if_noexcept(value(i)));
+          }
+          storage[i].left = nodes[i].left;
+          storage[i].right = nodes[i].right;
+          storage[i].parent = nodes[i].parent;
+        }
+      } catch (...) {
+        for (uint32_t j {0}; j < i; j++) {
+          if (storage[j].right != vacant) destroy_element(storage, j);
+        }
+        throw;
+      }
+      release();
+      nodes = storage;
+    }
+    void release() noexcept {
+      for (uint32_t i {0}; i < used; i++) {
+        if (nodes[i].right != vacant) destroy_element(nodes, i);
+      }
+      if (nodes) node_traits::deallocate(allocator, nodes, capacity);
+    }
+    template <typename K, typename V>
+    uint32_t create_node(K && key, V && value) {
+      uint32_t n {free_list};
+      if (n != null) {
+        construct(nodes, n, std::forward<K>(key), std::forward<V>(value));
+        free_list = nodes[n].left;
+      } else if (used < capacity) {
+        n = used;
+        ::new (static_cast<void *>(nodes + n)) crbnode;
+        construct(nodes, n, std::forward<K>(key), std::forward<V>(value));
+        used++;
+      } else {
+        if (capacity == null) throw std::length_error("compact_rbtree exceeds 2^31 - 1 nodes");
+        const uint32_t next_capacity {capacity ? (capacity > null / 2 ? null : 2 * capacity) : 16};
+        crbnode * storage {node_traits::allocate(allocator, next_capacity)};
+        n = used;
+        try {
+          ::new (static_cast<void *>(storage + n)) crbnode;
+          construct(storage, n, std::forward<K>(key), std::forward<V>(value));
+        } catch (...) {
+          node_traits::deallocate(allocator, storage, next_capacity);
+          throw;
+        }
+        try {
+          relocate(storage);
+        } catch (...) {
+          destroy_element(storage, n);
+          node_traits::deallocate(allocator, storage, next_capacity);
+          throw;
+        }
+        capacity = next_capacity;
+        used++;
+      }
+      nodes[n].left = null;
+      nodes[n].right = null;
+      nodes[n].parent = red | null;
+      element_count++;
+      return n;
+    }
+    void destroy_node(uint32_t n) noexcept {
+      destroy_element(nodes, n);
+      nodes[n].left = free_list;
+      nodes[n].right = vacant;
+      free_list = n;
+      element_count--;
+    }
+    uint32_t locate(const T & k) const {
+      uint32_t current {tree_root};
+      uint32_t candidate {null};
+      while (current != null) {
+        if (compare(k, key(current))) {
+          current = nodes[current].left;
+        } else {
+          candidate = current;
+          current = nodes[current].right;
+        }
+      }
+      if (candidate != null && !compare(key(candidate), k)) return candidate;
+      return null;
+    }
+    void replace_child(uint32_t p, uint32_t old_child, uint32_t new_child) noexcept {
+      if (p == null) {
+        tree_root = new_child;
+      } else if (nodes[p].left == old_child) {
+        nodes[p].left = new_child;
+      } else {
+        nodes[p].right = new_child;
+      }
+    }
+    void rotate_left(uint32_t rotation_root) noexcept {
+      const uint32_t new_root {nodes[rotation_root].right};
+      const uint32_t orphan_subtree {nodes[new_root].left};
+      nodes[rotation_root].right = orphan_subtree;
+      if (orphan_subtree != null) set_parent(orphan_subtree, rotation_root);
+      nodes[new_root].left = rotation_root;
+      replace_child(parent(rotation_root), rotation_root, new_root);
+      set_parent(new_root, parent(rotation_root));
+      set_parent(rotation_root, new_root);
+    }
+    void rotate_right(uint32_t rotation_root) noexcept {
+      const uint32_t new_root {nodes[rotation_root].left};
+      const uint32_t orphan_subtree {nodes[new_root].right};
+      nodes[rotation_root].left = orphan_subtree;
+      if (orphan_subtree != null) set_parent(orphan_subtree, rotation_root);
+      nodes[new_root].right = rotation_root;
+      replace_child(parent(rotation_root), rotation_root, new_root);
+      set_parent(new_root, parent(rotation_root));
+      set_parent(rotation_root, new_root);
+    }
+    void fix(uint32_t n) noexcept {
+      while (n != tree_root && is_red(n) && is_red(parent(n))) {
+        uint32_t p {parent(n)};
+        const uint32_t grand_parent {parent(p)};
+        if (p == nodes[grand_parent].left) {
+          const uint32_t uncle {nodes[grand_parent].right};
+          if (is_red(uncle)) {
+            paint(grand_parent, true);
+            paint(p, false);
+            paint(uncle, false);
+            n = grand_parent;
+          } else {
+            if (n == nodes[p].right) {
+              rotate_left(p);
+              n = p;
+              p = parent(n);
+            }
+            rotate_right(grand_parent);
+            paint(p, false);
+            paint(grand_parent, true);
+            n = p;
+          }
+        } else {
+          const uint32_t uncle {nodes[grand_parent].left};
+          if (is_red(uncle)) {
+            paint(grand_parent, true);
+            paint(p, false);
+            paint(uncle, false);
+            n = grand_parent;
+          } else {
+            if (n == nodes[p].left) {
+              rotate_right(p);
+              n = p;
+              p = parent(n);
+            }
+            rotate_left(grand_parent);
+            paint(p, false);
+            paint(grand_parent, true);
+            n = p;
+          }
+        }
+      }
+      paint(tree_root, false);
+    }
+    void transplant(uint32_t u, uint32_t v) noexcept {
+      replace_child(parent(u), u, v);
+      if (v != null) set_parent(v, parent(u));
+    }
+    void fix_erase(uint32_t n, uint32_t p) noexcept {
+      while (n != tree_root && !is_red(n)) {
+        if (n == nodes[p].left) {
+          uint32_t sibling {nodes[p].right};
+          if (is_red(sibling)) {
+            paint(sibling, false);
+            paint(p, true);
+            rotate_left(p);
+            sibling = nodes[p].right;
+          }
+          if (!is_red(nodes[sibling].left) && !is_red(nodes[sibling].right)) {
+            paint(sibling, true);
+            n = p;
+            p = parent(n);
+          } else {
+            if (!is_red(nodes[sibling].right)) {
+              paint(nodes[sibling].left, false);
+              paint(sibling, true);
+              rotate_right(sibling);
+              sibling = nodes[p].right;
+            }
+            paint(sibling, is_red(p));
+            paint(p, false);
+            paint(nodes[sibling].right, false);
+            rotate_left(p);
+            n = tree_root;
+          }
+        } else {
+          uint32_t sibling {nodes[p].left};
+          if (is_red(sibling)) {
+            paint(sibling, false);
+            paint(p, true);
+            rotate_right(p);
+            sibling = nodes[p].left;
+          }
+          if (!is_red(nodes[sibling].left) && !is_red(nodes[sibling].right)) {
+            paint(sibling, true);
+            n = p;
+            p = parent(n);
+          } else {
+            if (!is_red(nodes[sibling].left)) {
+              paint(nodes[sibling].right, false);
+              paint(sibling, true);
+              rotate_left(sibling);
+              sibling = nodes[p].left;
+            }
+            paint(sibling, is_red(p));
+            paint(p, false);
+            paint(nodes[sibling].left, false);
+            rotate_right(p);
+            n = tree_root;
+          }
+        }
+      }
+      if (n != null) paint(n, false);
+    }
+    void unlink(uint32_t target) noexcept {
+      uint32_t replacement {null};
+      uint32_t replacement_parent {null};
+      bool erased_red {is_red(target)};
+      if (nodes[target].left == null) {
+        replacement = nodes[target].right;
+        replacement_parent = parent(target);
+        transplant(target, replacement);
+      } else if (nodes[target].right == null) {
+        replacement = nodes[target].left;
+        replacement_parent = parent(target);
+        transplant(target, replacement);
+      } else {
+        uint32_t successor {nodes[target].right};
+        while (nodes[successor].left != null) successor = nodes[successor].left;
+        erased_red = is_red(successor);
+        replacement = nodes[successor].right;
+        if (parent(successor) == target) {
+          replacement_parent = successor;
+        } else {
+          replacement_parent = parent(successor);
+          transplant(successor, replacement);
+          nodes[successor].right = nodes[target].right;
+          set_parent(nodes[successor].right, successor);
+        }
+        transplant(target, successor);
+        nodes[successor].left = nodes[target].left;
+        set_parent(nodes[successor].left, successor);
+        paint(successor, is_red(target));
+      }
+      if (!erased_red) fix_erase(replacement, replacement_parent);
+    }
+    template <typename K, typename V>
+    std::pair <element_pointer, bool> assign_unique(K && k, V && v) {
+      uint32_t p {null};
+      uint32_t current {tree_root};
+      uint32_t candidate {null};
+      bool left {false};
+      while (current != null) {
+        p = current;
+        left = compare(k, key(current));
+        if (left) {
+          current = nodes[current].left;
+        } else {
+          candidate = current;
+          current = nodes[current].right;
+        }
+      }
+      if (candidate != null && !compare(key(candidate), k)) {
+        value(candidate) = std::forward<V>(v);
+        return {element_pointer(this, candidate), false};
+      }
+      const uint32_t n {create_node(std::forward<K>(k), std::forward<V>(v))};
+      set_parent(n, p);
+      if (p == null) {
+        tree_root = n;
+      } else if (left) {
+        nodes[p].left = n;
+      } else {
+        nodes[p].right = n;
+      }
+      fix(n);
+      return {element_pointer(this, n), true};
+    }
+    uint32_t pre_order_next(uint32_t n) const noexcept {
+      if (nodes[n].left != null) return nodes[n].left;
+      if (nodes[n].right != null) return nodes[n].right;
+      uint32_t p {parent(n)};
+      while (p != null && (n == nodes[p].right || nodes[p].right == null)) {
+        n = p;
+        p = parent(p);
+      }
+      return p != null ? nodes[p].right : null;
+    }
+    uint32_t post_order_first(uint32_t n) const noexcept {
+      while (nodes[n].left != null || nodes[n].right != null) n = nodes[n].left != null ? nodes[n].left : nodes[n].right;
+      return n;
+    }
+    uint32_t post_order_next(uint32_t n) const noexcept {
+      const uint32_t p {parent(n)};
+      if (p == null || n == nodes[p].right || nodes[p].right == null) return p;
+      return post_order_first(nodes[p].right);
+    }
+    template <typename Handler>
+    bool visit(Handler & handler, uint32_t n, std::true_type) {
+      handler(key(n), value(n));
+      return true;
+    }
+    template <typename Handler>
+    bool visit(Handler & handler, uint32_t n, std::false_type) {
+      return static_cast<bool>(handler(key(n), value(n)));
+    }
+    template <typename Handler>
+    bool visit(Handler & handler, uint32_t n) {
+      return visit(handler, n, std::is_void<decltype(handler(key(n), value(n)))>());
+    }
+  public:
+    compact_rbtree() = default;
+    explicit compact_rbtree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+
+    }
+    explicit compact_rbtree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    compact_rbtree(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      try {
+        for (; first != last; ++first) {
+          insert(first->first, first->second);
+        }
+      } catch (...) {
+        clear();
+        throw;
+      }
+    }
+    explicit compact_rbtree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compact_rbtree(list.begin(), list.end(), COMPARE, ALLOCATOR) {
+
+    }
+    compact_rbtree(const compact_rbtree &) = delete;
+    compact_rbtree(compact_rbtree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), nodes(other.nodes), capacity(other.capacity), used(other.used), free_list(other.free_list), tree_root(other.tree_root), element_count(other.element_count) {
+      other.nodes = nullptr;
+      other.capacity = 0;
+      other.used = 0;
+      other.free_list = null;
+      other.tree_root = null;
+      other.element_count = 0;
+    }
+    compact_rbtree& operator=(const compact_rbtree &) = delete;
+    compact_rbtree& operator=(compact_rbtree && other) {
+      if (this == &other) return *this;
+      clear();
+      compare = std::move(other.compare);
+      if (node_traits::propagate_on_container_move_assignment::value) {
+        allocator = std::move(other.allocator);
+      } else if (allocator != other.allocator) {
+        other.in_order_traversal([this](const T & key, const U & value) {
+          insert(std::move(const_cast<T &>(key)), std::move(const_cast<U &>(value)));
+        });
+        other.clear();
+        return *this;
+      }
+      nodes = other.nodes;
+      capacity = other.capacity;
+      used = other.used;
+      free_list = other.free_list;
+      tree_root = other.tree_root;
+      element_count = other.element_count;
+      other.nodes = nullptr;
+      other.capacity = 0;
+      other.used = 0;
+      other.free_list = null;
+      other.tree_root = null;
+      other.element_count = 0;
+      return *this;
+    }
+    ~compact_rbtree() {
+      clear();
+    }
+    template <typename Handler>
+    void pre_order_traversal(Handler handler) {
+      for (uint32_t current {tree_root}; current != null; current = pre_order_next(current)) {
+        if (!visit(handler, current)) return;
+      }
+    }
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      uint32_t current {tree_root};
+      if (current == null) return;
+      while (nodes[current].left != null) current = nodes[current].left;
+      while (current != null) {
+        if (!visit(handler, current)) return;
+        if (nodes[current].right != null) {
+          current = nodes[current].right;
+          while (nodes[current].left != null) current = nodes[current].left;
+        } else {
+          uint32_t p {parent(current)};
+          while (p != null && current == nodes[p].right) {
+            current = p;
+            p = parent(p);
+          }
+          current = p;
+        }
+      }
+    }
+    template <typename Handler>
+    void post_order_traversal(Handler handler) {
+      if (tree_root == null) return;
+      for (uint32_t current {post_order_first(tree_root)}; current != null; current = post_order_next(current)) {
+        if (!visit(handler, current)) return;
+      }
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <uint32_t> queue;
+      if (tree_root == null) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        const uint32_t current {queue.front()};
+        queue.pop();
+        if (!visit(handler, current)) return;
+        if (nodes[current].left != null) queue.push(nodes[current].left);
+        if (nodes[current].right != null) queue.push(nodes[current].right);
+      }
+    }
+    std::pair <element_pointer, bool> insert(const T & key, const U & value) {
+      return assign_unique(key, value);
+    }
+    std::pair <element_pointer, bool> insert(const T & key, U && value) {
+      return assign_unique(key, std::move(value));
+    }
+    std::pair <element_pointer, bool> insert(T && key, const U & value) {
+      return assign_unique(std::move(key), value);
+    }
+    std::pair <element_pointer, bool> insert(T && key, U && value) {
+      return assign_unique(std::move(key), std::move(value));
+    }
+    template <typename V>
+    std::pair <element_pointer, bool> insert_or_assign(const T & key, V && value) {
+      return assign_unique(key, std::forward<V>(value));
+    }
+    template <typename V>
+    std::pair <element_pointer, bool> insert_or_assign(T && key, V && value) {
+      return assign_unique(std::move(key), std::forward<V>(value));
+    }
+    size_t erase(const T & key) {
+      const uint32_t target {locate(key)};
+      if (target == null) return 0;
+      unlink(target);
+      destroy_node(target);
+      return 1;
+    }
+    element_pointer search(const T & key) const {
+      const uint32_t n {locate(key)};
+      if (n == null) return nullptr;
+      return element_pointer(this, n);
+    }
+    element_pointer minimum() const noexcept {
+      uint32_t current {tree_root};
+      if (current == null) return nullptr;
+      while (nodes[current].left != null) current = nodes[current].left;
+      return element_pointer(this, current);
+    }
+    element_pointer maximum() const noexcept {
+      uint32_t current {tree_root};
+      if (current == null) return nullptr;
+      while (nodes[current].right != null) current = nodes[current].right;
+      return element_pointer(this, current);
+    }
+    size_t height() const noexcept {
+      size_t result {0};
+      size_t depth {0};
+      uint32_t previous {null};
+      uint32_t current {tree_root};
+      while (current != null) {
+        uint32_t following {parent(current)};
+        if (previous == parent(current)) {
+          result = std::max(result, ++depth);
+          if (nodes[current].left != null) {
+            following = nodes[current].left;
+          } else if (nodes[current].right != null) {
+            following = nodes[current].right;
+          }
+        } else if (previous == nodes[current].left && nodes[current].right != null) {
+          following = nodes[current].right;
+        }
+        if (following == parent(current)) depth--;
+        previous = current;
+        current = following;
+      }
+      return result;
+    }
+    size_t size() const noexcept {
+      return element_count;
+    }
+    void reserve(size_t count) {
+      if (count <= capacity) return;
+      if (count > null) throw std::length_error("compact_rbtree exceeds 2^31 - 1 nodes");
+      const uint32_t next_capacity {static_cast<uint32_t>(count)};
+      crbnode * storage {node_traits::allocate(allocator, next_capacity)};
+      try {
+        relocate(storage);
+      } catch (...) {
+        node_traits::deallocate(allocator, storage, next_capacity);
+        throw;
+      }
+      capacity = next_capacity;
+    }
+    void clear() noexcept {
+      release();
+      nodes = nullptr;
+      capacity = 0;
+      used = 0;
+      free_list = null;
+      tree_root = null;
+      element_count = 0;
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return Allocator(allocator);
+    }
+    void swap(compact_rbtree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      if (node_traits::propagate_on_container_swap::value) {
+        swap(allocator, other.allocator);
+      }
+      swap(nodes, other.nodes);
+      swap(capacity, other.capacity);
+      swap(used, other.used);
+      swap(free_list, other.free_list);
+      swap(tree_root, other.tree_root);
+      swap(element_count, other.element_count);
+    }
+    friend void swap(compact_rbtree & lhs, compact_rbtree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return element_count == 0;
+    }
+  };
+}
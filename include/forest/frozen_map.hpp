@@ -0,0 +1,246 @@
+/**
+ * @file frozen_map.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace forest {
+  template <typename T, typename U, typename Compare = std::less <T> >
+  class frozen_map {
+  public:
+    class element {
+    public:
+      const T & key;
+      const U & value;
+      const element * operator->() const noexcept {
+        return this;
+      }
+    };
+    class element_pointer {
+    public:
+      element_pointer() = default;
+      element_pointer(std::nullptr_t) noexcept {
+
+      }
+      element operator*() const noexcept {
+        return {map->keys[index], map->values[index - 1]};
+      }
+      element operator->() const noexcept {
+        return **this;
+      }
+      explicit operator bool() const noexcept {
+        return map != nullptr;
+      }
+      friend bool operator==(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return lhs.map == rhs.map && lhs.index == rhs.index;
+      }
+      friend bool operator!=(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return !(lhs == rhs);
+      }
+      friend bool operator==(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return !lhs.map;
+      }
+      friend bool operator!=(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return lhs.map;
+      }
+      friend bool operator==(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return !rhs.map;
+      }
+      friend bool operator!=(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return rhs.map;
+      }
+    private:
+      element_pointer(const frozen_map * MAP, size_t INDEX) noexcept : map(MAP), index(INDEX) {
+
+      }
+      const frozen_map * map {nullptr};
+      size_t index {0};
+      friend class frozen_map;
+    };
+  private:
+    static constexpr size_t prefetch_stride {sizeof(T) < 64 ? 64 / sizeof(T) : 1};
+    Compare compare;
+    std::vector <T> keys;
+    std::vector <U> values;
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.first)) {
+      return element.first;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.key)) {
+      return element.key;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.second)) {
+      return element.second;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.value)) {
+      return element.value;
+    }
+    static void layout(std::vector <size_t> & order, size_t k, size_t & rank) {
+      if (k > order.size()) return;
+      layout(order, 2 * k, rank);
+      order[k - 1] = rank++;
+      layout(order, 2 * k + 1, rank);
+    }
+    template <typename ForwardIt>
+    void build(ForwardIt first, ForwardIt last) {
+      std::vector <ForwardIt> elements;
+      for (ForwardIt it {first}; it != last; ++it) {
+        elements.push_back(it);
+      }
+      auto less = [this](const ForwardIt & lhs, const ForwardIt & rhs) {
+        return compare(key_of(*lhs), key_of(*rhs));
+      };
+      if (!std::is_sorted(elements.begin(), elements.end(), less)) {
+        std::stable_sort(elements.begin(), elements.end(), less);
+      }
+      size_t unique {0};
+      for (size_t i {0}; i < elements.size(); i++) {
+        if (unique && !less(elements[unique - 1], elements[i])) {
+          elements[unique - 1] = elements[i];
+        } else {
+          elements[unique++] = elements[i];
+        }
+      }
+      elements.resize(unique);
+      if (elements.empty()) return;
+      std::vector <size_t> order(elements.size());
+      size_t rank {0};
+      layout(order, 1, rank);
+      keys.reserve(elements.size() + 1);
+      values.reserve(elements.size());
+      keys.push_back(key_of(*elements.front()));
+      for (size_t i : order) {
+        keys.push_back(key_of(*elements[i]));
+        values.push_back(value_of(*elements[i]));
+      }
+    }
+    static void prefetch(const T * address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(address);
+#else
+      (void)address;
+#endif
+    }
+    static size_t climb(size_t k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+      while (k & 1) k >>= 1;
+      return k >> 1;
+#endif
+    }
+    size_t first_not_less(const T & key) const {
+      const size_t n {values.size()};
+      const std::uintptr_t base {reinterpret_cast<std::uintptr_t>(keys.data())};
+      size_t k {1};
+      while (k <= n) {
+        prefetch(reinterpret_cast<const T *>(base + prefetch_stride * k * sizeof(T)));
+        k = 2 * k + static_cast<size_t>(compare(keys[k], key));
+      }
+      return climb(k);
+    }
+    size_t first_greater(const T & key) const {
+      const size_t n {values.size()};
+      const std::uintptr_t base {reinterpret_cast<std::uintptr_t>(keys.data())};
+      size_t k {1};
+      while (k <= n) {
+        prefetch(reinterpret_cast<const T *>(base + prefetch_stride * k * sizeof(T)));
+        k = 2 * k + static_cast<size_t>(!compare(key, keys[k]));
+      }
+      return climb(k);
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value, std::true_type) {
+      handler(key, value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value, std::false_type) {
+      return static_cast<bool>(handler(key, value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value) {
+      return visit(handler, key, value, std::is_void<decltype(handler(key, value))>());
+    }
+  public:
+    frozen_map() = default;
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    frozen_map(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare()) : compare(COMPARE) {
+      build(first, last);
+    }
+    explicit frozen_map(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare()) : compare(COMPARE) {
+      build(list.begin(), list.end());
+    }
+    template <typename Handler>
+    void in_order_traversal(Handler handler) const {
+      const size_t n {values.size()};
+      if (!n) return;
+      size_t k {1};
+      while (2 * k <= n) k *= 2;
+      while (k) {
+        if (!visit(handler, keys[k], values[k - 1])) return;
+        if (2 * k + 1 <= n) {
+          k = 2 * k + 1;
+          while (2 * k <= n) k *= 2;
+        } else {
+          k = climb(k);
+        }
+      }
+    }
+    element_pointer search(const T & key) const {
+      size_t k {first_not_less(key)};
+      if (!k || compare(key, keys[k])) return nullptr;
+      return element_pointer(this, k);
+    }
+    element_pointer ceiling(const T & key) const {
+      size_t k {first_not_less(key)};
+      if (!k) return nullptr;
+      return element_pointer(this, k);
+    }
+    element_pointer lower_bound(const T & key) const {
+      return ceiling(key);
+    }
+    element_pointer upper_bound(const T & key) const {
+      size_t k {first_greater(key)};
+      if (!k) return nullptr;
+      return element_pointer(this, k);
+    }
+    element_pointer minimum() const noexcept {
+      const size_t n {values.size()};
+      if (!n) return nullptr;
+      size_t k {1};
+      while (2 * k <= n) k *= 2;
+      return element_pointer(this, k);
+    }
+    element_pointer maximum() const noexcept {
+      const size_t n {values.size()};
+      if (!n) return nullptr;
+      size_t k {1};
+      while (2 * k + 1 <= n) k = 2 * k + 1;
+      return element_pointer(this, k);
+    }
+    size_t size() const noexcept {
+      return values.size();
+    }
+    bool empty() const noexcept {
+      return values.empty();
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+  };
+}
@@ -0,0 +1,410 @@
+/**
+ * @file intrusive_avltree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <type_traits>
+#include <utility>
+
+namespace forest {
+  template <typename Tag = void>
+  class intrusive_avltree_hook {
+  public:
+    intrusive_avltree_hook() = default;
+    intrusive_avltree_hook(const intrusive_avltree_hook &) noexcept {
+
+    }
+    intrusive_avltree_hook& operator=(const intrusive_avltree_hook &) noexcept {
+      return *this;
+    }
+    ~intrusive_avltree_hook() = default;
+  private:
+    template <typename, typename, typename, typename>
+    friend class intrusive_avltree;
+    intrusive_avltree_hook * parent {nullptr};
+    intrusive_avltree_hook * left {nullptr};
+    intrusive_avltree_hook * right {nullptr};
+    signed char balance {0};
+  };
+
+  template <typename T, typename KeyOf, typename Compare = std::less <typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type>, typename Tag = void>
+  class intrusive_avltree {
+  public:
+    using key_type = typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type;
+    using hook = intrusive_avltree_hook <Tag>;
+    static_assert(std::is_base_of <hook, T>::value, "T must derive from intrusive_avltree_hook <Tag>");
+  private:
+    KeyOf key_of;
+    Compare compare;
+    hook * tree_root {nullptr};
+    size_t element_count {0};
+    static T * element(hook * n) noexcept {
+      return static_cast<T *>(n);
+    }
+    using key_result = decltype(std::declval<const KeyOf &>()(std::declval<const T &>()));
+    key_result key(const hook * n) const {
+      return key_of(*static_cast<const T *>(n));
+    }
+    hook * find(const key_type & k) const {
+      hook * current {tree_root};
+      hook * candidate {nullptr};
+      while (current) {
+        if (compare(k, key(current))) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return candidate;
+      return nullptr;
+    }
+    void replace_child(hook * parent, hook * old_child, hook * new_child) noexcept {
+      if (!parent) {
+        tree_root = new_child;
+      } else if (parent->left == old_child) {
+        parent->left = new_child;
+      } else {
+        parent->right = new_child;
+      }
+    }
+    void rotate_left(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->right};
+      hook * orphan_subtree {new_root->left};
+      rotation_root->right = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->left = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    void rotate_right(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->left};
+      hook * orphan_subtree {new_root->right};
+      rotation_root->left = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->right = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    hook * rotate_left_balanced(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->right};
+      rotate_left(rotation_root);
+      if (new_root->balance == 0) {
+        rotation_root->balance = 1;
+        new_root->balance = -1;
+      } else {
+        rotation_root->balance = 0;
+        new_root->balance = 0;
+      }
+      return new_root;
+    }
+    hook * rotate_right_balanced(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->left};
+      rotate_right(rotation_root);
+      if (new_root->balance == 0) {
+        rotation_root->balance = -1;
+        new_root->balance = 1;
+      } else {
+        rotation_root->balance = 0;
+        new_root->balance = 0;
+      }
+      return new_root;
+    }
+    hook * rotate_right_left(hook * rotation_root) noexcept {
+      hook * child {rotation_root->right};
+      hook * new_root {child->left};
+      const int factor {new_root->balance};
+      rotate_right(child);
+      rotate_left(rotation_root);
+      rotation_root->balance = factor > 0 ? -1 : 0;
+      child->balance = factor < 0 ? 1 : 0;
+      new_root->balance = 0;
+      return new_root;
+    }
+    hook * rotate_left_right(hook * rotation_root) noexcept {
+      hook * child {rotation_root->left};
+      hook * new_root {child->right};
+      const int factor {new_root->balance};
+      rotate_left(child);
+      rotate_right(rotation_root);
+      rotation_root->balance = factor < 0 ? 1 : 0;
+      child->balance = factor > 0 ? -1 : 0;
+      new_root->balance = 0;
+      return new_root;
+    }
+    void fix(hook * n) noexcept {
+      for (hook * parent {n->parent}; parent; parent = n->parent) {
+        if (n == parent->right) {
+          if (parent->balance > 0) {
+            if (n->balance < 0) {
+              rotate_right_left(parent);
+            } else {
+              rotate_left_balanced(parent);
+            }
+            return;
+          }
+          if (parent->balance < 0) {
+            parent->balance = 0;
+            return;
+          }
+          parent->balance = 1;
+        } else {
+          if (parent->balance < 0) {
+            if (n->balance > 0) {
+              rotate_left_right(parent);
+            } else {
+              rotate_right_balanced(parent);
+            }
+            return;
+          }
+          if (parent->balance > 0) {
+            parent->balance = 0;
+            return;
+          }
+          parent->balance = -1;
+        }
+        n = parent;
+      }
+    }
+    void transplant(hook * u, hook * v) noexcept {
+      replace_child(u->parent, u, v);
+      if (v) v->parent = u->parent;
+    }
+    void fix_erase(hook * parent, bool shrunk_left) noexcept {
+      while (parent) {
+        hook * grand_parent {parent->parent};
+        const bool left_child {grand_parent && grand_parent->left == parent};
+        if (shrunk_left) {
+          if (parent->balance > 0) {
+            const int factor {parent->right->balance};
+            if (factor < 0) {
+              rotate_right_left(parent);
+            } else {
+              rotate_left_balanced(parent);
+            }
+            if (factor == 0) return;
+          } else if (parent->balance == 0) {
+            parent->balance = 1;
+            return;
+          } else {
+            parent->balance = 0;
+          }
+        } else {
+          if (parent->balance < 0) {
+            const int factor {parent->left->balance};
+            if (factor > 0) {
+              rotate_left_right(parent);
+            } else {
+              rotate_right_balanced(parent);
+            }
+            if (factor == 0) return;
+          } else if (parent->balance == 0) {
+            parent->balance = -1;
+            return;
+          } else {
+            parent->balance = 0;
+          }
+        }
+        shrunk_left = left_child;
+        parent = grand_parent;
+      }
+    }
+    void unlink(hook * target) noexcept {
+      hook * retrace {target->parent};
+      bool shrunk_left {retrace && retrace->left == target};
+      if (!target->left || !target->right) {
+        transplant(target, target->left ? target->left : target->right);
+      } else {
+        hook * successor {target->right};
+        while (successor->left) successor = successor->left;
+        retrace = successor;
+        shrunk_left = false;
+        if (successor->parent != target) {
+          retrace = successor->parent;
+          shrunk_left = true;
+          transplant(successor, successor->right);
+          successor->right = target->right;
+          successor->right->parent = successor;
+        }
+        transplant(target, successor);
+        successor->left = target->left;
+        successor->left->parent = successor;
+        successor->balance = target->balance;
+      }
+      target->parent = nullptr;
+      target->left = nullptr;
+      target->right = nullptr;
+      element_count--;
+      fix_erase(retrace, shrunk_left);
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::true_type) {
+      handler(*element(n));
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::false_type) {
+      return static_cast<bool>(handler(*element(n)));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n) {
+      return visit(handler, n, std::is_void<decltype(handler(*element(n)))>());
+    }
+  public:
+    intrusive_avltree() = default;
+    explicit intrusive_avltree(const KeyOf & KEY_OF, const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    intrusive_avltree(ForwardIt first, ForwardIt last, const KeyOf & KEY_OF = KeyOf(), const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
+    }
+    intrusive_avltree(const intrusive_avltree &) = delete;
+    intrusive_avltree(intrusive_avltree && other) noexcept : key_of(std::move(other.key_of)), compare(std::move(other.compare)), tree_root(other.tree_root), element_count(other.element_count) {
+      other.tree_root = nullptr;
+      other.element_count = 0;
+    }
+    intrusive_avltree& operator=(const intrusive_avltree &) = delete;
+    intrusive_avltree& operator=(intrusive_avltree && other) noexcept {
+      if (this == &other) return *this;
+      key_of = std::move(other.key_of);
+      compare = std::move(other.compare);
+      tree_root = other.tree_root;
+      element_count = other.element_count;
+      other.tree_root = nullptr;
+      other.element_count = 0;
+      return *this;
+    }
+    ~intrusive_avltree() = default;
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      hook * current {tree_root};
+      if (!current) return;
+      while (current->left) current = current->left;
+      while (current) {
+        if (!visit(handler, current)) return;
+        if (current->right) {
+          current = current->right;
+          while (current->left) current = current->left;
+        } else {
+          hook * parent {current->parent};
+          while (parent && current == parent->right) {
+            current = parent;
+            parent = parent->parent;
+          }
+          current = parent;
+        }
+      }
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <hook *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        hook * current {queue.front()};
+        queue.pop();
+        if (!visit(handler, current)) return;
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
+      }
+    }
+    std::pair <T *, bool> insert(T & value) {
+      hook * n {&value};
+      hook * parent {nullptr};
+      hook * current {tree_root};
+      bool left {false};
+      hook * candidate {nullptr};
+      const key_type & k {key(n)};
+      while (current) {
+        parent = current;
+        left = compare(k, key(current));
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return {element(candidate), false};
+      n->parent = parent;
+      n->left = nullptr;
+      n->right = nullptr;
+      n->balance = 0;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      element_count++;
+      fix(n);
+      return {&value, true};
+    }
+    size_t erase(const key_type & key) {
+      hook * target {find(key)};
+      if (!target) return 0;
+      unlink(target);
+      return 1;
+    }
+    void erase(T & value) noexcept {
+      unlink(&value);
+    }
+    T * search(const key_type & key) const {
+      return element(find(key));
+    }
+    T * minimum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->left) current = current->left;
+      return element(current);
+    }
+    T * maximum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->right) current = current->right;
+      return element(current);
+    }
+    size_t height() const noexcept {
+      size_t result {0};
+      for (const hook * current {tree_root}; current; current = current->balance > 0 ? current->right : current->left) {
+        result++;
+      }
+      return result;
+    }
+    size_t size() const noexcept {
+      return element_count;
+    }
+    void clear() noexcept {
+      tree_root = nullptr;
+      element_count = 0;
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    void swap(intrusive_avltree & other) noexcept {
+      using std::swap;
+      swap(key_of, other.key_of);
+      swap(compare, other.compare);
+      swap(tree_root, other.tree_root);
+      swap(element_count, other.element_count);
+    }
+    friend void swap(intrusive_avltree & lhs, intrusive_avltree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return element_count == 0;
+    }
+  };
+}
@@ -0,0 +1,419 @@
+/**
+ * @file intrusive_rbtree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <type_traits>
+#include <utility>
+
+namespace forest {
+  template <typename Tag = void>
+  class intrusive_rbtree_hook {
+  public:
+    intrusive_rbtree_hook() = default;
+    intrusive_rbtree_hook(const intrusive_rbtree_hook &) noexcept {
+
+    }
+    intrusive_rbtree_hook& operator=(const intrusive_rbtree_hook &) noexcept {
+      return *this;
+    }
+    ~intrusive_rbtree_hook() = default;
+  private:
+    template <typename, typename, typename, typename>
+    friend class intrusive_rbtree;
+    intrusive_rbtree_hook * parent {nullptr};
+    intrusive_rbtree_hook * left {nullptr};
+    intrusive_rbtree_hook * right {nullptr};
+    bool red {false};
+  };
+
+  template <typename T, typename KeyOf, typename Compare = std::less <typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type>, typename Tag = void>
+  class intrusive_rbtree {
+  public:
+    using key_type = typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type;
+    using hook = intrusive_rbtree_hook <Tag>;
+    static_assert(std::is_base_of <hook, T>::value, "T must derive from intrusive_rbtree_hook <Tag>");
+  private:
+    KeyOf key_of;
+    Compare compare;
+    hook * tree_root {nullptr};
+    size_t element_count {0};
+    static T * element(hook * n) noexcept {
+      return static_cast<T *>(n);
+    }
+    using key_result = decltype(std::declval<const KeyOf &>()(std::declval<const T &>()));
+    key_result key(const hook * n) const {
+      return key_of(*static_cast<const T *>(n));
+    }
+    static bool is_red(const hook * n) noexcept {
+      return n && n->red;
+    }
+    hook * find(const key_type & k) const {
+      hook * current {tree_root};
+      hook * candidate {nullptr};
+      while (current) {
+        if (compare(k, key(current))) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return candidate;
+      return nullptr;
+    }
+    void replace_child(hook * parent, hook * old_child, hook * new_child) noexcept {
+      if (!parent) {
+        tree_root = new_child;
+      } else if (parent->left == old_child) {
+        parent->left = new_child;
+      } else {
+        parent->right = new_child;
+      }
+    }
+    void rotate_left(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->right};
+      hook * orphan_subtree {new_root->left};
+      rotation_root->right = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->left = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    void rotate_right(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->left};
+      hook * orphan_subtree {new_root->right};
+      rotation_root->left = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->right = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    void fix(hook * n) noexcept {
+      while (n != tree_root && n->red && n->parent->red) {
+        hook * parent {n->parent};
+        hook * grand_parent {parent->parent};
+        if (parent == grand_parent->left) {
+          hook * uncle {grand_parent->right};
+          if (is_red(uncle)) {
+            grand_parent->red = true;
+            parent->red = false;
+            uncle->red = false;
+            n = grand_parent;
+          } else {
+            if (n == parent->right) {
+              rotate_left(parent);
+              n = parent;
+              parent = n->parent;
+            }
+            rotate_right(grand_parent);
+            parent->red = false;
+            grand_parent->red = true;
+            n = parent;
+          }
+        } else {
+          hook * uncle {grand_parent->left};
+          if (is_red(uncle)) {
+            grand_parent->red = true;
+            parent->red = false;
+            uncle->red = false;
+            n = grand_parent;
+          } else {
+            if (n == parent->left) {
+              rotate_right(parent);
+              n = parent;
+              parent = n->parent;
+            }
+            rotate_left(grand_parent);
+            parent->red = false;
+            grand_parent->red = true;
+            n = parent;
+          }
+        }
+      }
+      tree_root->red = false;
+    }
+    void transplant(hook * u, hook * v) noexcept {
+      replace_child(u->parent, u, v);
+      if (v) v->parent = u->parent;
+    }
+    void fix_erase(hook * n, hook * parent) noexcept {
+      while (n != tree_root && !is_red(n)) {
+        if (n == parent->left) {
+          hook * sibling {parent->right};
+          if (sibling->red) {
+            sibling->red = false;
+            parent->red = true;
+            rotate_left(parent);
+            sibling = parent->right;
+          }
+          if (!is_red(sibling->left) && !is_red(sibling->right)) {
+            sibling->red = true;
+            n = parent;
+            parent = n->parent;
+          } else {
+            if (!is_red(sibling->right)) {
+              sibling->left->red = false;
+              sibling->red = true;
+              rotate_right(sibling);
+              sibling = parent->right;
+            }
+            sibling->red = parent->red;
+            parent->red = false;
+            sibling->right->red = false;
+            rotate_left(parent);
+            n = tree_root;
+          }
+        } else {
+          hook * sibling {parent->left};
+          if (sibling->red) {
+            sibling->red = false;
+            parent->red = true;
+            rotate_right(parent);
+            sibling = parent->left;
+          }
+          if (!is_red(sibling->left) && !is_red(sibling->right)) {
+            sibling->red = true;
+            n = parent;
+            parent = n->parent;
+          } else {
+            if (!is_red(sibling->left)) {
+              sibling->right->red = false;
+              sibling->red = true;
+              rotate_left(sibling);
+              sibling = parent->left;
+            }
+            sibling->red = parent->red;
+            parent->red = false;
+            sibling->left->red = false;
+            rotate_right(parent);
+            n = tree_root;
+          }
+        }
+      }
+      if (n) n->red = false;
+    }
+    void unlink(hook * target) noexcept {
+      hook * replacement {nullptr};
+      hook * replacement_parent {nullptr};
+      bool erased_red {target->red};
+      if (!target->left) {
+        replacement = target->right;
+        replacement_parent = target->parent;
+        transplant(target, replacement);
+      } else if (!target->right) {
+        replacement = target->left;
+        replacement_parent = target->parent;
+        transplant(target, replacement);
+      } else {
+        hook * successor {target->right};
+        while (successor->left) successor = successor->left;
+        erased_red = successor->red;
+        replacement = successor->right;
+        if (successor->parent == target) {
+          replacement_parent = successor;
+        } else {
+          replacement_parent = successor->parent;
+          transplant(successor, replacement);
+          successor->right = target->right;
+          successor->right->parent = successor;
+        }
+        transplant(target, successor);
+        successor->left = target->left;
+        successor->left->parent = successor;
+        successor->red = target->red;
+      }
+      target->parent = nullptr;
+      target->left = nullptr;
+      target->right = nullptr;
+      element_count--;
+      if (!erased_red) fix_erase(replacement, replacement_parent);
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::true_type) {
+      handler(*element(n));
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::false_type) {
+      return static_cast<bool>(handler(*element(n)));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n) {
+      return visit(handler, n, std::is_void<decltype(handler(*element(n)))>());
+    }
+  public:
+    intrusive_rbtree() = default;
+    explicit intrusive_rbtree(const KeyOf & KEY_OF, const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    intrusive_rbtree(ForwardIt first, ForwardIt last, const KeyOf & KEY_OF = KeyOf(), const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
+    }
+    intrusive_rbtree(const intrusive_rbtree &) = delete;
+    intrusive_rbtree(intrusive_rbtree && other) noexcept : key_of(std::move(other.key_of)), compare(std::move(other.compare)), tree_root(other.tree_root), element_count(other.element_count) {
+      other.tree_root = nullptr;
+      other.element_count = 0;
+    }
+    intrusive_rbtree& operator=(const intrusive_rbtree &) = delete;
+    intrusive_rbtree& operator=(intrusive_rbtree && other) noexcept {
+      if (this == &other) return *this;
+      key_of = std::move(other.key_of);
+      compare = std::move(other.compare);
+      tree_root = other.tree_root;
+      element_count = other.element_count;
+      other.tree_root = nullptr;
+      other.element_count = 0;
+      return *this;
+    }
+    ~intrusive_rbtree() = default;
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      hook * current {tree_root};
+      if (!current) return;
+      while (current->left) current = current->left;
+      while (current) {
+        if (!visit(handler, current)) return;
+        if (current->right) {
+          current = current->right;
+          while (current->left) current = current->left;
+        } else {
+          hook * parent {current->parent};
+          while (parent && current == parent->right) {
+            current = parent;
+            parent = parent->parent;
+          }
+          current = parent;
+        }
+      }
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <hook *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        hook * current {queue.front()};
+        queue.pop();
+        if (!visit(handler, current)) return;
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
+      }
+    }
+    std::pair <T *, bool> insert(T & value) {
+      hook * n {&value};
+      hook * parent {nullptr};
+      hook * current {tree_root};
+      bool left {false};
+      hook * candidate {nullptr};
+      const key_type & k {key(n)};
+      while (current) {
+        parent = current;
+        left = compare(k, key(current));
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return {element(candidate), false};
+      n->parent = parent;
+      n->left = nullptr;
+      n->right = nullptr;
+      n->red = true;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      element_count++;
+      fix(n);
+      return {&value, true};
+    }
+    size_t erase(const key_type & key) {
+      hook * target {find(key)};
+      if (!target) return 0;
+      unlink(target);
+      return 1;
+    }
+    void erase(T & value) noexcept {
+      unlink(&value);
+    }
+    T * search(const key_type & key) const {
+      return element(find(key));
+    }
+    T * minimum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->left) current = current->left;
+      return element(current);
+    }
+    T * maximum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->right) current = current->right;
+      return element(current);
+    }
+    size_t height() const noexcept {
+      size_t result {0};
+      size_t depth {0};
+      const hook * previous {nullptr};
+      const hook * current {tree_root};
+      while (current) {
+        const hook * following {current->parent};
+        if (previous == current->parent) {
+          result = std::max(result, ++depth);
+          if (current->left) {
+            following = current->left;
+          } else if (current->right) {
+            following = current->right;
+          }
+        } else if (previous == current->left && current->right) {
+          following = current->right;
+        }
+        if (following == current->parent) depth--;
+        previous = current;
+        current = following;
+      }
+      return result;
+    }
+    size_t size() const noexcept {
+      return element_count;
+    }
+    void clear() noexcept {
+      tree_root = nullptr;
+      element_count = 0;
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    void swap(intrusive_rbtree & other) noexcept {
+      using std::swap;
+      swap(key_of, other.key_of);
+      swap(compare, other.compare);
+      swap(tree_root, other.tree_root);
+      swap(element_count, other.element_count);
+    }
+    friend void swap(intrusive_rbtree & lhs, intrusive_rbtree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return element_count == 0;
+    }
+  };
+}
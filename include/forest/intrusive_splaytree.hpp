@@ -0,0 +1,319 @@
+/**
+ * @file intrusive_splaytree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <type_traits>
+#include <utility>
+
+namespace forest {
+  template <typename Tag = void>
+  class intrusive_splaytree_hook {
+  public:
+    intrusive_splaytree_hook() = default;
+    intrusive_splaytree_hook(const intrusive_splaytree_hook &) noexcept {
+
+    }
+    intrusive_splaytree_hook& operator=(const intrusive_splaytree_hook &) noexcept {
+      return *this;
+    }
+    ~intrusive_splaytree_hook() = default;
+  private:
+    template <typename, typename, typename, typename>
+    friend class intrusive_splaytree;
+    intrusive_splaytree_hook * parent {nullptr};
+    intrusive_splaytree_hook * left {nullptr};
+    intrusive_splaytree_hook * right {nullptr};
+  };
+
+  template <typename T, typename KeyOf, typename Compare = std::less <typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type>, typename Tag = void>
+  class intrusive_splaytree {
+  public:
+    using key_type = typename std::decay <decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>::type;
+    using hook = intrusive_splaytree_hook <Tag>;
+    static_assert(std::is_base_of <hook, T>::value, "T must derive from intrusive_splaytree_hook <Tag>");
+  private:
+    KeyOf key_of;
+    Compare compare;
+    hook * tree_root {nullptr};
+    size_t element_count {0};
+    static T * element(hook * n) noexcept {
+      return static_cast<T *>(n);
+    }
+    using key_result = decltype(std::declval<const KeyOf &>()(std::declval<const T &>()));
+    key_result key(const hook * n) const {
+      return key_of(*static_cast<const T *>(n));
+    }
+    hook * find(const key_type & k) const {
+      hook * current {tree_root};
+      hook * candidate {nullptr};
+      while (current) {
+        if (compare(k, key(current))) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return candidate;
+      return nullptr;
+    }
+    void replace_child(hook * parent, hook * old_child, hook * new_child) noexcept {
+      if (!parent) {
+        tree_root = new_child;
+      } else if (parent->left == old_child) {
+        parent->left = new_child;
+      } else {
+        parent->right = new_child;
+      }
+    }
+    void rotate_left(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->right};
+      hook * orphan_subtree {new_root->left};
+      rotation_root->right = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->left = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    void rotate_right(hook * rotation_root) noexcept {
+      hook * new_root {rotation_root->left};
+      hook * orphan_subtree {new_root->right};
+      rotation_root->left = orphan_subtree;
+      if (orphan_subtree) orphan_subtree->parent = rotation_root;
+      new_root->right = rotation_root;
+      replace_child(rotation_root->parent, rotation_root, new_root);
+      new_root->parent = rotation_root->parent;
+      rotation_root->parent = new_root;
+    }
+    void fix(hook * n) noexcept {
+      while (n->parent) {
+        hook * parent {n->parent};
+        hook * grand_parent {parent->parent};
+        if (!grand_parent) {
+          if (parent->left == n) {
+            rotate_right(parent);
+          } else {
+            rotate_left(parent);
+          }
+        } else if (parent->left == n && grand_parent->left == parent) {
+          rotate_right(grand_parent);
+          rotate_right(parent);
+        } else if (parent->right == n && grand_parent->right == parent) {
+          rotate_left(grand_parent);
+          rotate_left(parent);
+        } else if (parent->left == n) {
+          rotate_right(parent);
+          rotate_left(grand_parent);
+        } else {
+          rotate_left(parent);
+          rotate_right(grand_parent);
+        }
+      }
+    }
+    void unlink(hook * target) noexcept {
+      fix(target);
+      hook * left_subtree {target->left};
+      hook * right_subtree {target->right};
+      if (left_subtree) left_subtree->parent = nullptr;
+      if (right_subtree) right_subtree->parent = nullptr;
+      if (!left_subtree) {
+        tree_root = right_subtree;
+      } else {
+        tree_root = left_subtree;
+        hook * predecessor {left_subtree};
+        while (predecessor->right) predecessor = predecessor->right;
+        fix(predecessor);
+        predecessor->right = right_subtree;
+        if (right_subtree) right_subtree->parent = predecessor;
+      }
+      target->left = nullptr;
+      target->right = nullptr;
+      element_count--;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::true_type) {
+      handler(*element(n));
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n, std::false_type) {
+      return static_cast<bool>(handler(*element(n)));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, hook * n) {
+      return visit(handler, n, std::is_void<decltype(handler(*element(n)))>());
+    }
+  public:
+    intrusive_splaytree() = default;
+    explicit intrusive_splaytree(const KeyOf & KEY_OF, const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    intrusive_splaytree(ForwardIt first, ForwardIt last, const KeyOf & KEY_OF = KeyOf(), const Compare & COMPARE = Compare()) : key_of(KEY_OF), compare(COMPARE) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
+    }
+    intrusive_splaytree(const intrusive_splaytree &) = delete;
+    intrusive_splaytree(intrusive_splaytree && other) noexcept : key_of(std::move(other.key_of)), compare(std::move(other.compare)), tree_root(other.tree_root), element_count(other.element_count) {
+      other.tree_root = nullptr;
+      other.element_count = 0;
+    }
+    intrusive_splaytree& operator=(const intrusive_splaytree &) = delete;
+    intrusive_splaytree& operator=(intrusive_splaytree && other) noexcept {
+      if (this == &other) return *this;
+      key_of = std::move(other.key_of);
+      compare = std::move(other.compare);
+      tree_root = other.tree_root;
+      element_count = other.element_count;
+      other.tree_root = nullptr;
+      other.element_count = 0;
+      return *this;
+    }
+    ~intrusive_splaytree() = default;
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      hook * current {tree_root};
+      if (!current) return;
+      while (current->left) current = current->left;
+      while (current) {
+        if (!visit(handler, current)) return;
+        if (current->right) {
+          current = current->right;
+          while (current->left) current = current->left;
+        } else {
+          hook * parent {current->parent};
+          while (parent && current == parent->right) {
+            current = parent;
+            parent = parent->parent;
+          }
+          current = parent;
+        }
+      }
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <hook *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        hook * current {queue.front()};
+        queue.pop();
+        if (!visit(handler, current)) return;
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
+      }
+    }
+    std::pair <T *, bool> insert(T & value) {
+      hook * n {&value};
+      hook * parent {nullptr};
+      hook * current {tree_root};
+      bool left {false};
+      hook * candidate {nullptr};
+      const key_type & k {key(n)};
+      while (current) {
+        parent = current;
+        left = compare(k, key(current));
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(key(candidate), k)) return {element(candidate), false};
+      n->parent = parent;
+      n->left = nullptr;
+      n->right = nullptr;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      element_count++;
+      fix(n);
+      return {&value, true};
+    }
+    size_t erase(const key_type & key) {
+      hook * target {find(key)};
+      if (!target) return 0;
+      unlink(target);
+      return 1;
+    }
+    void erase(T & value) noexcept {
+      unlink(&value);
+    }
+    T * search(const key_type & key) const {
+      return element(find(key));
+    }
+    T * minimum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->left) current = current->left;
+      return element(current);
+    }
+    T * maximum() const noexcept {
+      hook * current {tree_root};
+      if (!current) return nullptr;
+      while (current->right) current = current->right;
+      return element(current);
+    }
+    size_t height() const noexcept {
+      size_t result {0};
+      size_t depth {0};
+      const hook * previous {nullptr};
+      const hook * current {tree_root};
+      while (current) {
+        const hook * following {current->parent};
+        if (previous == current->parent) {
+          result = std::max(result, ++depth);
+          if (current->left) {
+            following = current->left;
+          } else if (current->right) {
+            following = current->right;
+          }
+        } else if (previous == current->left && current->right) {
+          following = current->right;
+        }
+        if (following == current->parent) depth--;
+        previous = current;
+        current = following;
+      }
+      return result;
+    }
+    size_t size() const noexcept {
+      return element_count;
+    }
+    void clear() noexcept {
+      tree_root = nullptr;
+      element_count = 0;
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    void swap(intrusive_splaytree & other) noexcept {
+      using std::swap;
+      swap(key_of, other.key_of);
+      swap(compare, other.compare);
+      swap(tree_root, other.tree_root);
+      swap(element_count, other.element_count);
+    }
+    friend void swap(intrusive_splaytree & lhs, intrusive_splaytree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return element_count == 0;
+    }
+  };
+}
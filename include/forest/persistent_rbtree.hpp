@@ -0,0 +1,335 @@
+/**
+ * @file persistent_rbtree.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace forest {
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> > >
+  class persistent_rbtree {
+  private:
+    enum rbcolor {
+      RED,
+      BLACK
+    };
+    class prbnode;
+    using node_ptr = std::shared_ptr <const prbnode>;
+    class prbnode {
+    public:
+      template <typename K, typename V>
+      prbnode(rbcolor COLOR, node_ptr LEFT, K && KEY, V && VALUE, node_ptr RIGHT) : key(std::forward<K>(KEY)), value(std::forward<V>(VALUE)), color(COLOR), size((LEFT ? LEFT->size : 0) + (RIGHT ? RIGHT->size : 0) + 1), left(std::move(LEFT)), right(std::move(RIGHT)) {
+
+      }
+      prbnode(const prbnode &) = delete;
+      prbnode(prbnode &&) = delete;
+      prbnode& operator=(const prbnode &) = delete;
+      prbnode& operator=(prbnode &&) = delete;
+      ~prbnode() = default;
+      T key;
+      U value;
+      friend class persistent_rbtree;
+    private:
+      rbcolor color {RED};
+      size_t size {1};
+      node_ptr left;
+      node_ptr right;
+    };
+    Compare compare;
+    Allocator allocator;
+    node_ptr tree_root;
+    template <typename K, typename V>
+    node_ptr make_node(rbcolor color, node_ptr left, K && key, V && value, node_ptr right) const {
+      return std::allocate_shared<prbnode>(allocator, color, std::move(left), std::forward<K>(key), std::forward<V>(value), std::move(right));
+    }
+    node_ptr recolor(const node_ptr & n, rbcolor color) const {
+      if (n->color == color) return n;
+      return make_node(color, n->left, n->key, n->value, n->right);
+    }
+    static bool is_red(const node_ptr & n) noexcept {
+      return n && n->color == RED;
+    }
+    static bool is_black(const node_ptr & n) noexcept {
+      return n && n->color == BLACK;
+    }
+    node_ptr balance(const node_ptr & l, const T & key, const U & value, const node_ptr & r) const {
+      if (is_red(l) && is_red(r)) {
+        return make_node(RED, recolor(l, BLACK), key, value, recolor(r, BLACK));
+      }
+      if (is_red(l) && is_red(l->left)) {
+        return make_node(RED, recolor(l->left, BLACK), l->key, l->value, make_node(BLACK, l->right, key, value, r));
+      }
+      if (is_red(l) && is_red(l->right)) {
+        return make_node(RED, make_node(BLACK, l->left, l->key, l->value, l->right->left), l->right->key, l->right->value, make_node(BLACK, l->right->right, key, value, r));
+      }
+      if (is_red(r) && is_red(r->right)) {
+        return make_node(RED, make_node(BLACK, l, key, value, r->left), r->key, r->value, recolor(r->right, BLACK));
+      }
+      if (is_red(r) && is_red(r->left)) {
+        return make_node(RED, make_node(BLACK, l, key, value, r->left->left), r->left->key, r->left->value, make_node(BLACK, r->left->right, r->key, r->value, r->right));
+      }
+      return make_node(BLACK, l, key, value, r);
+    }
+    node_ptr balance_left(const node_ptr & l, const T & key, const U & value, const node_ptr & r) const {
+      if (is_red(l)) {
+        return make_node(RED, recolor(l, BLACK), key, value, r);
+      }
+      if (is_black(r)) {
+        return balance(l, key, value, recolor(r, RED));
+      }
+      return make_node(RED, make_node(BLACK, l, key, value, r->left->left), r->left->key, r->left->value, balance(r->left->right, r->key, r->value, recolor(r->right, RED)));
+    }
+    node_ptr balance_right(const node_ptr & l, const T & key, const U & value, const node_ptr & r) const {
+      if (is_red(r)) {
+        return make_node(RED, l, key, value, recolor(r, BLACK));
+      }
+      if (is_black(l)) {
+        return balance(recolor(l, RED), key, value, r);
+      }
+      return make_node(RED, balance(recolor(l->left, RED), l->key, l->value, l->right->left), l->right->key, l->right->value, make_node(BLACK, l->right->right, key, value, r));
+    }
+    template <typename V>
+    node_ptr insert_into(const node_ptr & n, const T & key, V && value, bool & inserted) const {
+      if (!n) {
+        inserted = true;
+        return make_node(RED, nullptr, key, std::forward<V>(value), nullptr);
+      }
+      if (compare(key, n->key)) {
+        node_ptr left {insert_into(n->left, key, std::forward<V>(value), inserted)};
+        if (n->color == BLACK) return balance(left, n->key, n->value, n->right);
+        return make_node(RED, std::move(left), n->key, n->value, n->right);
+      }
+      if (compare(n->key, key)) {
+        node_ptr right {insert_into(n->right, key, std::forward<V>(value), inserted)};
+        if (n->color == BLACK) return balance(n->left, n->key, n->value, right);
+        return make_node(RED, n->left, n->key, n->value, std::move(right));
+      }
+      return make_node(n->color, n->left, n->key, std::forward<V>(value), n->right);
+    }
+    node_ptr append(const node_ptr & a, const node_ptr & b) const {
+      if (!a) return b;
+      if (!b) return a;
+      if (a->color != b->color) {
+        if (is_red(b)) return make_node(RED, append(a, b->left), b->key, b->value, b->right);
+        return make_node(RED, a->left, a->key, a->value, append(a->right, b));
+      }
+      node_ptr middle {append(a->right, b->left)};
+      if (is_red(middle)) {
+        return make_node(RED, make_node(a->color, a->left, a->key, a->value, middle->left), middle->key, middle->value, make_node(b->color, middle->right, b->key, b->value, b->right));
+      }
+      if (a->color == RED) {
+        return make_node(RED, a->left, a->key, a->value, make_node(RED, middle, b->key, b->value, b->right));
+      }
+      return balance_left(a->left, a->key, a->value, make_node(BLACK, middle, b->key, b->value, b->right));
+    }
+    node_ptr erase_from(const node_ptr & n, const T & key) const {
+      if (compare(key, n->key)) {
+        node_ptr left {erase_from(n->left, key)};
+        if (n->left->color == BLACK) return balance_left(left, n->key, n->value, n->right);
+        return make_node(RED, std::move(left), n->key, n->value, n->right);
+      }
+      if (compare(n->key, key)) {
+        node_ptr right {erase_from(n->right, key)};
+        if (n->right->color == BLACK) return balance_right(n->left, n->key, n->value, right);
+        return make_node(RED, n->left, n->key, n->value, std::move(right));
+      }
+      return append(n->left, n->right);
+    }
+    node_ptr load() const noexcept {
+      return std::atomic_load(&tree_root);
+    }
+    const prbnode * find(const prbnode * current, const T & key) const {
+      while (current) {
+        if (compare(key, current->key)) {
+          current = current->left.get();
+        } else if (compare(current->key, key)) {
+          current = current->right.get();
+        } else {
+          return current;
+        }
+      }
+      return nullptr;
+    }
+    template <typename V>
+    bool assign_path(const T & key, V && value) {
+      bool inserted {false};
+      node_ptr result {insert_into(load(), key, std::forward<V>(value), inserted)};
+      std::atomic_store(&tree_root, recolor(result, BLACK));
+      return inserted;
+    }
+    static size_t height(const prbnode * n) noexcept {
+      if (!n) return 0;
+      return std::max(height(n->left.get()), height(n->right.get())) + 1;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const prbnode * n, std::true_type) {
+      handler(n->key, n->value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const prbnode * n, std::false_type) {
+      return static_cast<bool>(handler(n->key, n->value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const prbnode * n) {
+      return visit(handler, n, std::is_void<decltype(handler(n->key, n->value))>());
+    }
+  public:
+    persistent_rbtree() = default;
+    explicit persistent_rbtree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+
+    }
+    explicit persistent_rbtree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    explicit persistent_rbtree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      for (const std::pair <T, U> & element : list) {
+        insert(element.first, element.second);
+      }
+    }
+    persistent_rbtree(const persistent_rbtree & other) : compare(other.compare), allocator(other.allocator), tree_root(other.load()) {
+
+    }
+    persistent_rbtree(persistent_rbtree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), tree_root(std::move(other.tree_root)) {
+
+    }
+    persistent_rbtree& operator=(const persistent_rbtree & other) {
+      if (this == &other) return *this;
+      compare = other.compare;
+      allocator = other.allocator;
+      std::atomic_store(&tree_root, other.load());
+      return *this;
+    }
+    persistent_rbtree& operator=(persistent_rbtree && other) noexcept {
+      if (this == &other) return *this;
+      compare = std::move(other.compare);
+      allocator = std::move(other.allocator);
+      std::atomic_store(&tree_root, std::move(other.tree_root));
+      return *this;
+    }
+    ~persistent_rbtree() = default;
+    persistent_rbtree snapshot() const {
+      return *this;
+    }
+    template <typename Handler>
+    void in_order_traversal(Handler handler) const {
+      std::vector <const prbnode *> stack;
+      const node_ptr root {load()};
+      const prbnode * current {root.get()};
+      while (current || !stack.empty()) {
+        while (current) {
+          stack.push_back(current);
+          current = current->left.get();
+        }
+        current = stack.back();
+        stack.pop_back();
+        if (!visit(handler, current)) return;
+        current = current->right.get();
+      }
+    }
+    bool insert(const T & key, const U & value) {
+      return assign_path(key, value);
+    }
+    bool insert(const T & key, U && value) {
+      return assign_path(key, std::move(value));
+    }
+    size_t erase(const T & key) {
+      const node_ptr root {load()};
+      if (!find(root.get(), key)) return 0;
+      node_ptr result {erase_from(root, key)};
+      std::atomic_store(&tree_root, result ? recolor(result, BLACK) : result);
+      return 1;
+    }
+    node_ptr search(const T & key) const {
+      const node_ptr root {load()};
+      const prbnode * found {find(root.get(), key)};
+      if (!found) return nullptr;
+      return node_ptr(root, found);
+    }
+    node_ptr minimum() const noexcept {
+      const node_ptr root {load()};
+      const prbnode * current {root.get()};
+      if (!current) return nullptr;
+      while (current->left) current = current->left.get();
+      return node_ptr(root, current);
+    }
+    node_ptr maximum() const noexcept {
+      const node_ptr root {load()};
+      const prbnode * current {root.get()};
+      if (!current) return nullptr;
+      while (current->right) current = current->right.get();
+      return node_ptr(root, current);
+    }
+    size_t rank(const T & key) const {
+      size_t result {0};
+      const node_ptr root {load()};
+      const prbnode * current {root.get()};
+      while (current) {
+        if (compare(current->key, key)) {
+          result += (current->left ? current->left->size : 0) + 1;
+          current = current->right.get();
+        } else {
+          current = current->left.get();
+        }
+      }
+      return result;
+    }
+    node_ptr select(size_t index) const {
+      const node_ptr root {load()};
+      const prbnode * current {root.get()};
+      while (current) {
+        size_t left_size {current->left ? current->left->size : 0};
+        if (index < left_size) {
+          current = current->left.get();
+        } else if (index > left_size) {
+          index -= left_size + 1;
+          current = current->right.get();
+        } else {
+          return node_ptr(root, current);
+        }
+      }
+      return nullptr;
+    }
+    size_t height() const noexcept {
+      return height(load().get());
+    }
+    size_t size() const noexcept {
+      const node_ptr root {load()};
+      return root ? root->size : 0;
+    }
+    void clear() noexcept {
+      std::atomic_store(&tree_root, node_ptr());
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return allocator;
+    }
+    void swap(persistent_rbtree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      swap(allocator, other.allocator);
+      node_ptr root {load()};
+      std::atomic_store(&tree_root, other.load());
+      std::atomic_store(&other.tree_root, std::move(root));
+    }
+    friend void swap(persistent_rbtree & lhs, persistent_rbtree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
+      return !load();
+    }
+    node_ptr root() const noexcept {
+      return load();
+    }
+  };
+}
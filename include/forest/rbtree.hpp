@@ -5,81 +5,283 @@
 
 #pragma once
 
+#include "arena.hpp"
+#include "frozen_map.hpp"
+#include "thread_pool.hpp"
+
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <queue>
+#include <random>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace forest {
-  template <typename T, typename U>
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> > >
   class rbtree {
   private:
     enum rbcolor {
       RED,
       BLACK
     };
+    enum set_operation {
+      UNION,
+      INTERSECTION,
+      DIFFERENCE
+    };
     class rbnode {
     public:
       rbnode() = default;
-      rbnode(const T & KEY, const U & VALUE, const rbcolor & COLOR) : key(KEY), value(VALUE), color(COLOR) {
+      template <typename K, typename... Args>
+      rbnode(K && KEY, Args &&... ARGS) : key(std::forward<K>(KEY)), value(std::forward<Args>(ARGS)...) {
 
       }
       rbnode(const rbnode &) = delete;
       rbnode(rbnode &&) = delete;
       rbnode& operator=(const rbnode &) = delete;
       rbnode& operator=(rbnode &&) = delete;
-      ~rbnode() {
-        delete left;
-        delete right;
-      }
+      ~rbnode() = default;
       T key;
       U value;
       friend class rbtree;
     private:
-      rbcolor color;
+      rbcolor color {RED};
+      size_t size {1};
       rbnode * parent {nullptr};
       rbnode * left {nullptr};
       rbnode * right {nullptr};
     };
+    using node_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <rbnode>;
+    using node_traits = std::allocator_traits <node_allocator>;
+    Compare compare;
+    node_allocator allocator;
     rbnode * tree_root {nullptr};
-    void pre_order_traversal(const rbnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      handler(root->key, root->value);
-      pre_order_traversal(root->left, handler);
-      pre_order_traversal(root->right, handler);
-    }
-    void in_order_traversal(const rbnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      in_order_traversal(root->left, handler);
-      handler(root->key, root->value);
-      in_order_traversal(root->right, handler);
-    }
-    void post_order_traversal(const rbnode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      post_order_traversal(root->left, handler);
-      post_order_traversal(root->right, handler);
-      handler(root->key, root->value);
-    }
-    void breadth_first_traversal(const rbnode * root, void handler(const T & key, const U & value)) noexcept {
-      std::queue <const rbnode *> queue;
-      if (!root) return;
-      queue.push(root);
-      while (!queue.empty()) {
-        rbnode * current {queue.front()};
-        handler(current->key, current->value);
-        queue.pop();
-        if (current->left) queue.push(current->left);
-        if (current->right) queue.push(current->right);
+    rbnode * rightmost {nullptr};
+    void * free_list {nullptr};
+    static constexpr size_t parallel_grain {4096};
+    template <typename... Args>
+    rbnode * create_node(Args &&... args) {
+      rbnode * storage {static_cast<rbnode *>(free_list)};
+      if (storage) {
+        free_list = *static_cast<void **>(free_list);
+      } else {
+        storage = node_traits::allocate(allocator, 1);
       }
+      try {
+        node_traits::construct(allocator, storage, std::forward<Args>(args)...);
+      } catch (...) {
+        *reinterpret_cast<void **>(storage) = free_list;
+        free_list = storage;
+        throw;
+      }
+      return storage;
+    }
+    void recycle_node(rbnode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      *reinterpret_cast<void **>(n) = free_list;
+      free_list = n;
+    }
+    void destroy_node(rbnode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      node_traits::deallocate(allocator, n, 1);
+    }
+    void destroy_subtree(rbnode * root) noexcept {
+      rbnode * current {root};
+      while (current) {
+        if (current->left) {
+          current = current->left;
+        } else if (current->right) {
+          current = current->right;
+        } else {
+          rbnode * parent {current == root ? nullptr : current->parent};
+          if (parent && parent->left == current) {
+            parent->left = nullptr;
+          } else if (parent) {
+            parent->right = nullptr;
+          }
+          destroy_node(current);
+          current = parent;
+        }
+      }
+    }
+    void release_free_list() noexcept {
+      while (free_list) {
+        void * next {*static_cast<void **>(free_list)};
+        node_traits::deallocate(allocator, static_cast<rbnode *>(free_list), 1);
+        free_list = next;
+      }
+    }
+    void transplant(rbnode * u, rbnode * v) noexcept {
+      if (!u->parent) {
+        tree_root = v;
+      } else if (u == u->parent->left) {
+        u->parent->left = v;
+      } else {
+        u->parent->right = v;
+      }
+      if (v) v->parent = u->parent;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const rbnode * n, std::true_type) {
+      handler(n->key, n->value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const rbnode * n, std::false_type) {
+      return static_cast<bool>(handler(n->key, n->value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const rbnode * n) {
+      return visit(handler, n, std::is_void<decltype(handler(n->key, n->value))>());
+    }
+    rbnode * find(const T & key) {
+      rbnode * candidate {last_not_greater(key)};
+      if (candidate && !compare(candidate->key, key)) return candidate;
+      return nullptr;
+    }
+    rbnode * last_not_greater(const T & key) {
+      rbnode * current {tree_root};
+      rbnode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      return candidate;
+    }
+    rbnode * first_not_less(const T & key) {
+      rbnode * current {tree_root};
+      rbnode * candidate {nullptr};
+      while (current) {
+        if (compare(current->key, key)) {
+          current = current->right;
+        } else {
+          candidate = current;
+          current = current->left;
+        }
+      }
+      return candidate;
+    }
+    rbnode * first_greater(const T & key) {
+      rbnode * current {tree_root};
+      rbnode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          candidate = current;
+          current = current->left;
+        } else {
+          current = current->right;
+        }
+      }
+      return candidate;
+    }
+    rbnode * locate(const T & key, rbnode *& parent, bool & left) {
+      return locate(key, parent, left, tree_root);
+    }
+    rbnode * locate(const T & key, rbnode *& parent, bool & left, rbnode * start) {
+      if (rightmost && compare(rightmost->key, key)) {
+        parent = rightmost;
+        left = false;
+        return nullptr;
+      }
+      rbnode * current {start};
+      rbnode * candidate {nullptr};
+      parent = nullptr;
+      left = false;
+      while (current) {
+        parent = current;
+        left = compare(key, current->key);
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(candidate->key, key)) return candidate;
+      return nullptr;
+    }
+    static const rbnode * pre_order_next(const rbnode * n) noexcept {
+      if (n->left) return n->left;
+      if (n->right) return n->right;
+      const rbnode * parent {n->parent};
+      while (parent && (n == parent->right || !parent->right)) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent ? parent->right : nullptr;
+    }
+    static const rbnode * post_order_first(const rbnode * n) noexcept {
+      while (n->left || n->right) n = n->left ? n->left : n->right;
+      return n;
+    }
+    static const rbnode * post_order_next(const rbnode * n) noexcept {
+      const rbnode * parent {n->parent};
+      if (!parent || n == parent->right || !parent->right) return parent;
+      return post_order_first(parent->right);
+    }
+    static const rbnode * next(const rbnode * n) noexcept {
+      if (n->right) {
+        n = n->right;
+        while (n->left) n = n->left;
+        return n;
+      }
+      const rbnode * parent {n->parent};
+      while (parent && n == parent->right) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
+    }
+    static const rbnode * previous(const rbnode * n) noexcept {
+      if (n->left) {
+        n = n->left;
+        while (n->right) n = n->right;
+        return n;
+      }
+      const rbnode * parent {n->parent};
+      while (parent && n == parent->left) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
     }
     size_t height(const rbnode * root) noexcept {
-      if (!root) return 0;
-      return std::max(height(root->left), height(root->right)) + 1;
+      size_t result {0};
+      size_t depth {0};
+      const rbnode * previous {nullptr};
+      const rbnode * current {root};
+      while (current) {
+        const rbnode * following {current->parent};
+        if (previous == current->parent) {
+          result = std::max(result, ++depth);
+          if (current->left) {
+            following = current->left;
+          } else if (current->right) {
+            following = current->right;
+          }
+        } else if (previous == current->left && current->right) {
+          following = current->right;
+        }
+        if (following == current->parent) depth--;
+        previous = current;
+        current = following;
+        if (previous == root && current == root->parent) break;
+      }
+      return result;
     }
     size_t size(const rbnode * root) noexcept {
       if (!root) return 0;
-      return size(root->left) + size(root->right) + 1;
+      return root->size;
     }
     void rotate_right(rbnode * rotation_root) noexcept {
       rbnode * new_root {rotation_root->left};
@@ -98,6 +300,8 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
     }
     void rotate_left(rbnode * rotation_root) noexcept {
       rbnode * new_root {rotation_root->right};
@@ -116,8 +320,10 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
     }
-    void fix(rbnode * n) noexcept {
+    bool fix(rbnode * n) noexcept {
       rbnode * parent {nullptr};
       rbnode * grand_parent {nullptr};
       while ((n != tree_root) && (n->color != BLACK) && (n->parent->color == RED)) {
@@ -159,71 +365,857 @@ namespace forest {
           }
         }
       }
+      const bool grown {tree_root->color == RED};
       tree_root->color = BLACK;
+      return grown;
+    }
+    void fix_erase(rbnode * n, rbnode * parent) noexcept {
+      while (n != tree_root && (!n || n->color == BLACK)) {
+        if (n == parent->left) {
+          rbnode * sibling {parent->right};
+          if (sibling->color == RED) {
+            sibling->color = BLACK;
+            parent->color = RED;
+            rotate_left(parent);
+            sibling = parent->right;
+          }
+          if ((!sibling->left || sibling->left->color == BLACK) && (!sibling->right || sibling->right->color == BLACK)) {
+            sibling->color = RED;
+            n = parent;
+            parent = n->parent;
+          } else {
+            if (!sibling->right || sibling->right->color == BLACK) {
+              sibling->left->color = BLACK;
+              sibling->color = RED;
+              rotate_right(sibling);
+              sibling = parent->right;
+            }
+            sibling->color = parent->color;
+            parent->color = BLACK;
+            sibling->right->color = BLACK;
+            rotate_left(parent);
+            n = tree_root;
+          }
+        } else {
+          rbnode * sibling {parent->left};
+          if (sibling->color == RED) {
+            sibling->color = BLACK;
+            parent->color = RED;
+            rotate_right(parent);
+            sibling = parent->left;
+          }
+          if ((!sibling->left || sibling->left->color == BLACK) && (!sibling->right || sibling->right->color == BLACK)) {
+            sibling->color = RED;
+            n = parent;
+            parent = n->parent;
+          } else {
+            if (!sibling->left || sibling->left->color == BLACK) {
+              sibling->right->color = BLACK;
+              sibling->color = RED;
+              rotate_left(sibling);
+              sibling = parent->left;
+            }
+            sibling->color = parent->color;
+            parent->color = BLACK;
+            sibling->left->color = BLACK;
+            rotate_right(parent);
+            n = tree_root;
+          }
+        }
+      }
+      if (n) n->color = BLACK;
+    }
+    void link(rbnode * n, rbnode * parent, bool left) {
+      n->parent = parent;
+      if (!parent || (parent == rightmost && !left)) rightmost = n;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      for (rbnode * ancestor {parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size++;
+      }
+      fix(n);
+    }
+    template <typename K, typename... Args>
+    std::pair <rbnode *, bool> emplace_unique(K && key, Args &&... args) {
+      rbnode * parent {nullptr};
+      bool left {false};
+      rbnode * existing {locate(key, parent, left)};
+      if (existing) return {existing, false};
+      rbnode * n {create_node(std::forward<K>(key), std::forward<Args>(args)...)};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <rbnode *, bool> assign_unique(K && key, V && value) {
+      rbnode * parent {nullptr};
+      bool left {false};
+      rbnode * existing {locate(key, parent, left)};
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      rbnode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <rbnode *, bool> assign_hinted(const rbnode * hint, K && key, V && value) {
+      rbnode * position {const_cast<rbnode *>(hint)};
+      rbnode * parent {nullptr};
+      bool left {false};
+      rbnode * existing {nullptr};
+      if (position && compare(key, position->key)) {
+        rbnode * before {const_cast<rbnode *>(previous(position))};
+        if (!before || compare(before->key, key)) {
+          left = !position->left;
+          parent = left ? position : before;
+        } else {
+          existing = locate(key, parent, left);
+        }
+      } else if (position && !compare(position->key, key)) {
+        existing = position;
+      } else {
+        existing = locate(key, parent, left);
+      }
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      rbnode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.first)) {
+      return element.first;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.key)) {
+      return element.key;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.second)) {
+      return element.second;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.value)) {
+      return element.value;
+    }
+    template <typename ForwardIt>
+    std::vector <ForwardIt> gather(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements;
+      for (ForwardIt it {first}; it != last; ++it) {
+        elements.push_back(it);
+      }
+      auto less = [this](const ForwardIt & lhs, const ForwardIt & rhs) {
+        return compare(key_of(*lhs), key_of(*rhs));
+      };
+      if (!std::is_sorted(elements.begin(), elements.end(), less)) {
+        if (pool) {
+          parallel_stable_sort(elements.begin(), elements.end(), less, *pool);
+        } else {
+          std::stable_sort(elements.begin(), elements.end(), less);
+        }
+      }
+      size_t unique {0};
+      for (size_t i {0}; i < elements.size(); i++) {
+        if (unique && !less(elements[unique - 1], elements[i])) {
+          elements[unique - 1] = elements[i];
+        } else {
+          elements[unique++] = elements[i];
+        }
+      }
+      elements.resize(unique);
+      return elements;
+    }
+    static size_t deepest_level(size_t n) noexcept {
+      size_t level {0};
+      for (; n > 1; n >>= 1) level++;
+      return level;
+    }
+    rbnode * climb(rbnode * finger, const T & key) {
+      if (!finger) return tree_root;
+      while (finger->parent && !(finger == finger->parent->left && compare(key, finger->parent->key))) {
+        finger = finger->parent;
+      }
+      return finger;
+    }
+    void relink(const std::vector <rbnode *> & nodes, size_t lo, size_t hi, rbnode * parent, rbnode *& slot, size_t depth, size_t red_depth) noexcept {
+      if (lo == hi) {
+        slot = nullptr;
+        return;
+      }
+      const size_t middle {lo + (hi - lo) / 2};
+      rbnode * n {nodes[middle]};
+      n->parent = parent;
+      n->size = hi - lo;
+      n->color = depth && depth == red_depth ? RED : BLACK;
+      slot = n;
+      relink(nodes, lo, middle, n, n->left, depth + 1, red_depth);
+      relink(nodes, middle + 1, hi, n, n->right, depth + 1, red_depth);
+    }
+    template <typename ForwardIt>
+    void merge(const std::vector <ForwardIt> & elements) {
+      std::vector <rbnode *> nodes;
+      nodes.reserve(size());
+      for (const rbnode * n {begin().node}; n; n = next(n)) {
+        nodes.push_back(const_cast<rbnode *>(n));
+      }
+      std::vector <rbnode *> merged;
+      merged.reserve(nodes.size() + elements.size());
+      std::vector <rbnode *> fresh;
+      fresh.reserve(elements.size());
+      size_t i {0};
+      try {
+        for (const ForwardIt & element : elements) {
+          while (i < nodes.size() && compare(nodes[i]->key, key_of(*element))) {
+            merged.push_back(nodes[i++]);
+          }
+          if (i < nodes.size() && !compare(key_of(*element), nodes[i]->key)) {
+            nodes[i]->value = value_of(*element);
+            merged.push_back(nodes[i++]);
+          } else {
+            fresh.push_back(create_node(key_of(*element), value_of(*element)));
+            merged.push_back(fresh.back());
+          }
+        }
+      } catch (...) {
+        for (rbnode * n : fresh) {
+          recycle_node(n);
+        }
+        throw;
+      }
+      while (i < nodes.size()) {
+        merged.push_back(nodes[i++]);
+      }
+      relink(merged, 0, merged.size(), nullptr, tree_root, 0, deepest_level(merged.size()));
+      rightmost = merged.empty() ? nullptr : merged.back();
+    }
+    template <typename ForwardIt>
+    void build(const std::vector <ForwardIt> & elements, const std::vector <rbnode *> & storage, std::vector <char> & constructed, size_t lo, size_t hi, size_t index, rbnode * parent, rbnode *& slot, size_t depth, size_t red_depth, thread_pool * pool) {
+      if (lo == hi) return;
+      const size_t middle {lo + (hi - lo) / 2};
+      rbnode * n {storage[index]};
+      node_traits::construct(allocator, n, key_of(*elements[middle]), value_of(*elements[middle]));
+      constructed[index] = true;
+      n->parent = parent;
+      n->size = hi - lo;
+      n->color = depth && depth == red_depth ? RED : BLACK;
+      slot = n;
+      fork(pool, hi - lo, [&] {
+        build(elements, storage, constructed, lo, middle, index + 1, n, n->left, depth + 1, red_depth, pool);
+      }, [&] {
+        build(elements, storage, constructed, middle + 1, hi, index + 1 + middle - lo, n, n->right, depth + 1, red_depth, pool);
+      });
+    }
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements {gather(first, last, pool)};
+      std::vector <char> constructed(elements.size());
+      std::vector <rbnode *> storage;
+      storage.reserve(elements.size());
+      clear();
+      try {
+        while (storage.size() < elements.size()) {
+          storage.push_back(node_traits::allocate(allocator, 1));
+        }
+        build(elements, storage, constructed, 0, elements.size(), 0, nullptr, tree_root, 0, deepest_level(elements.size()), pool);
+      } catch (...) {
+        for (size_t i {0}; i < storage.size(); i++) {
+          if (constructed[i]) node_traits::destroy(allocator, storage[i]);
+          node_traits::deallocate(allocator, storage[i], 1);
+        }
+        tree_root = nullptr;
+        throw;
+      }
+      update_rightmost();
+    }
+    void unlink(rbnode * target) noexcept {
+      if (target == rightmost) rightmost = const_cast<rbnode *>(previous(target));
+      rbnode * replacement {nullptr};
+      rbnode * replacement_parent {nullptr};
+      rbcolor erased_color {target->color};
+      if (!target->left) {
+        replacement = target->right;
+        replacement_parent = target->parent;
+        transplant(target, target->right);
+      } else if (!target->right) {
+        replacement = target->left;
+        replacement_parent = target->parent;
+        transplant(target, target->left);
+      } else {
+        rbnode * successor {target->right};
+        while (successor->left) successor = successor->left;
+        erased_color = successor->color;
+        replacement = successor->right;
+        if (successor->parent == target) {
+          replacement_parent = successor;
+        } else {
+          replacement_parent = successor->parent;
+          transplant(successor, successor->right);
+          successor->right = target->right;
+          successor->right->parent = successor;
+        }
+        transplant(target, successor);
+        successor->left = target->left;
+        successor->left->parent = successor;
+        successor->color = target->color;
+        successor->size = target->size;
+      }
+      for (rbnode * ancestor {replacement_parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size--;
+      }
+      if (erased_color == BLACK) {
+        fix_erase(replacement, replacement_parent);
+      }
+    }
+    static size_t black_height(const rbnode * n) noexcept {
+      size_t result {0};
+      for (; n; n = n->left) {
+        result += n->color == BLACK;
+      }
+      return result;
+    }
+    size_t join_roots(rbnode * l, size_t l_height, rbnode * middle, rbnode * r, size_t r_height) noexcept {
+      const size_t joined_height {std::max(l_height, r_height)};
+      rbnode * root {nullptr};
+      rbnode * parent {nullptr};
+      if (l_height > r_height) {
+        root = l;
+        while (l_height > r_height || (l && l->color == RED)) {
+          l_height -= l->color == BLACK;
+          parent = l;
+          l = l->right;
+        }
+        parent->right = middle;
+      } else if (r_height > l_height) {
+        root = r;
+        while (r_height > l_height || (r && r->color == RED)) {
+          r_height -= r->color == BLACK;
+          parent = r;
+          r = r->left;
+        }
+        parent->left = middle;
+      }
+      middle->parent = parent;
+      middle->left = l;
+      middle->right = r;
+      if (l) l->parent = middle;
+      if (r) r->parent = middle;
+      middle->size = size(l) + size(r) + 1;
+      if (!parent) {
+        middle->color = BLACK;
+        tree_root = middle;
+        return joined_height + 1;
+      }
+      const size_t added {middle->size - size(parent->right == middle ? l : r)};
+      for (rbnode * ancestor {parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size += added;
+      }
+      middle->color = RED;
+      tree_root = root;
+      return joined_height + fix(middle);
+    }
+    void append(rbnode * middle, rbtree & right) {
+      if (allocator != right.allocator) {
+        if (middle) link(middle, rightmost, false);
+        for (const rbnode * n {right.begin().node}; n; n = next(n)) {
+          rbnode * source {const_cast<rbnode *>(n)};
+          rbnode * copy {create_node(std::move(source->key), std::move(source->value))};
+          link(copy, rightmost, false);
+        }
+        right.clear();
+        return;
+      }
+      if (!middle) {
+        if (!right.tree_root) return;
+        middle = right.tree_root;
+        while (middle->left) middle = middle->left;
+        right.unlink(middle);
+      }
+      join_roots(tree_root, black_height(tree_root), middle, right.tree_root, black_height(right.tree_root));
+      rightmost = right.rightmost ? right.rightmost : middle;
+      right.tree_root = nullptr;
+      right.rightmost = nullptr;
+    }
+    static rbnode * detach(rbnode * n, size_t & n_height) noexcept {
+      if (!n) return nullptr;
+      n->parent = nullptr;
+      if (n->color == RED) {
+        n->color = BLACK;
+        n_height++;
+      }
+      return n;
+    }
+    rbnode * split_into(rbnode * n, size_t n_height, const T & key, rbtree & lesser, size_t & lesser_height, rbtree & greater, size_t & greater_height) {
+      if (!n) return nullptr;
+      size_t piece_height {n_height - (n->color == BLACK)};
+      if (compare(n->key, key)) {
+        rbnode * found {split_into(n->right, piece_height, key, lesser, lesser_height, greater, greater_height)};
+        rbnode * piece {detach(n->left, piece_height)};
+        lesser_height = lesser.join_roots(piece, piece_height, n, lesser.tree_root, lesser_height);
+        return found;
+      }
+      if (compare(key, n->key)) {
+        rbnode * found {split_into(n->left, piece_height, key, lesser, lesser_height, greater, greater_height)};
+        rbnode * piece {detach(n->right, piece_height)};
+        greater_height = greater.join_roots(greater.tree_root, greater_height, n, piece, piece_height);
+        return found;
+      }
+      lesser_height = piece_height;
+      greater_height = piece_height;
+      lesser.tree_root = detach(n->left, lesser_height);
+      greater.tree_root = detach(n->right, greater_height);
+      return n;
+    }
+    size_t concat_roots(rbtree & left, size_t left_height, rbtree & right, size_t right_height) noexcept {
+      if (!right.tree_root) {
+        tree_root = left.tree_root;
+        return left_height;
+      }
+      if (!left.tree_root) {
+        tree_root = right.tree_root;
+        return right_height;
+      }
+      rbnode * middle {right.tree_root};
+      while (middle->left) middle = middle->left;
+      right.unlink(middle);
+      return join_roots(left.tree_root, left_height, middle, right.tree_root, black_height(right.tree_root));
+    }
+    template <typename First, typename Second>
+    static void fork(thread_pool * pool, size_t work, First && first, Second && second) {
+      if (pool && work >= parallel_grain) {
+        pool->invoke(first, second);
+      } else {
+        first();
+        second();
+      }
+    }
+    template <typename Handler>
+    static void for_each_subtree(const rbnode * n, Handler & handler, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        const rbnode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          handler(current->key, current->value);
+        }
+        return;
+      }
+      fork(pool, n->size, [&] {
+        if (n->left) for_each_subtree(n->left, handler, pool);
+      }, [&] {
+        handler(n->key, n->value);
+        if (n->right) for_each_subtree(n->right, handler, pool);
+      });
+    }
+    template <typename R, typename Map, typename Combine>
+    static R reduce_subtree(const rbnode * n, const R & identity, Map & map, Combine & combine, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        R result {identity};
+        const rbnode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          result = combine(std::move(result), map(current->key, current->value));
+        }
+        return result;
+      }
+      R left {identity};
+      R right {identity};
+      fork(pool, n->size, [&] {
+        if (n->left) left = reduce_subtree(n->left, identity, map, combine, pool);
+      }, [&] {
+        if (n->right) right = reduce_subtree(n->right, identity, map, combine, pool);
+      });
+      return combine(combine(std::move(left), map(n->key, n->value)), std::move(right));
+    }
+    static size_t combine(set_operation operation, rbtree & a, size_t a_height, rbtree & b, size_t b_height, thread_pool * pool, std::vector <rbnode *> & discarded) {
+      if (!a.tree_root || !b.tree_root) {
+        size_t result {a_height};
+        if (operation == UNION && !a.tree_root) {
+          a.tree_root = b.tree_root;
+          result = b_height;
+        } else if (b.tree_root) {
+          discarded.push_back(b.tree_root);
+        }
+        if (operation == INTERSECTION && a.tree_root) {
+          discarded.push_back(a.tree_root);
+          a.tree_root = nullptr;
+          result = 0;
+        }
+        b.tree_root = nullptr;
+        return result;
+      }
+      const size_t work {a.size(a.tree_root) + b.size(b.tree_root)};
+      rbnode * pivot {b.tree_root};
+      b.tree_root = nullptr;
+      size_t left_height {b_height - (pivot->color == BLACK)};
+      size_t right_height {left_height};
+      rbtree other_left {b.scratch()};
+      rbtree other_right {b.scratch()};
+      other_left.tree_root = detach(pivot->left, left_height);
+      other_right.tree_root = detach(pivot->right, right_height);
+      rbtree lesser {a.scratch()};
+      rbtree greater {a.scratch()};
+      size_t lesser_height {0};
+      size_t greater_height {0};
+      rbnode * found {a.split_into(a.tree_root, a_height, pivot->key, lesser, lesser_height, greater, greater_height)};
+      a.tree_root = nullptr;
+      std::vector <rbnode *> greater_discarded;
+      fork(pool, work, [&] {
+        lesser_height = combine(operation, lesser, lesser_height, other_left, left_height, pool, discarded);
+      }, [&] {
+        greater_height = combine(operation, greater, greater_height, other_right, right_height, pool, greater_discarded);
+      });
+      discarded.insert(discarded.end(), greater_discarded.begin(), greater_discarded.end());
+      rbnode * middle {operation == UNION ? pivot : operation == INTERSECTION ? found : nullptr};
+      for (rbnode * n : {pivot, found}) {
+        if (!n || n == middle) continue;
+        n->left = nullptr;
+        n->right = nullptr;
+        discarded.push_back(n);
+      }
+      size_t result {0};
+      if (middle) {
+        result = a.join_roots(lesser.tree_root, lesser_height, middle, greater.tree_root, greater_height);
+      } else {
+        result = a.concat_roots(lesser, lesser_height, greater, greater_height);
+      }
+      lesser.tree_root = nullptr;
+      greater.tree_root = nullptr;
+      return result;
+    }
+    void combine_with(set_operation operation, rbtree & other, thread_pool * pool) {
+      if (this == &other) {
+        if (operation == DIFFERENCE) clear();
+        return;
+      }
+      if (allocator != other.allocator) {
+        for (const rbnode * n {other.begin().node}; n; n = next(n)) {
+          rbnode * source {const_cast<rbnode *>(n)};
+          if (operation == UNION) {
+            assign_unique(std::move(source->key), std::move(source->value));
+          } else if (operation == DIFFERENCE) {
+            erase(source->key);
+          }
+        }
+        if (operation == INTERSECTION) {
+          for (const rbnode * n {begin().node}; n; ) {
+            const rbnode * following {next(n)};
+            if (!other.find(n->key)) erase(n->key);
+            n = following;
+          }
+        }
+        other.clear();
+        return;
+      }
+      std::vector <rbnode *> discarded;
+      combine(operation, *this, black_height(tree_root), other, black_height(other.tree_root), pool, discarded);
+      other.rightmost = nullptr;
+      update_rightmost();
+      for (rbnode * n : discarded) {
+        destroy_subtree(n);
+      }
+    }
+    rbtree scratch() const {
+      return rbtree(compare, Allocator(allocator));
+    }
+    void update_rightmost() noexcept {
+      rightmost = tree_root;
+      while (rightmost && rightmost->right) rightmost = rightmost->right;
     }
   public:
-    rbtree() = default;
-    explicit rbtree(std::initializer_list <std::pair <T, U> > list) {
-      for (auto element : list) {
-        insert(element.first, element.second);
+    class iterator {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = rbnode;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const rbnode *;
+      using reference = const rbnode &;
+      iterator() = default;
+      reference operator*() const noexcept {
+        return *node;
       }
+      pointer operator->() const noexcept {
+        return node;
+      }
+      iterator & operator++() noexcept {
+        node = next(node);
+        return *this;
+      }
+      iterator operator++(int) noexcept {
+        iterator result {*this};
+        ++*this;
+        return result;
+      }
+      iterator & operator--() noexcept {
+        if (node) {
+          node = previous(node);
+        } else {
+          node = tree->rightmost;
+        }
+        return *this;
+      }
+      iterator operator--(int) noexcept {
+        iterator result {*this};
+        --*this;
+        return result;
+      }
+      friend bool operator==(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node == rhs.node;
+      }
+      friend bool operator!=(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node != rhs.node;
+      }
+    private:
+      iterator(const rbnode * NODE, const rbtree * TREE) : node(NODE), tree(TREE) {
+
+      }
+      const rbnode * node {nullptr};
+      const rbtree * tree {nullptr};
+      friend class rbtree;
+    };
+    using const_iterator = iterator;
+    using reverse_iterator = std::reverse_iterator <iterator>;
+    using const_reverse_iterator = reverse_iterator;
+    rbtree() = default;
+    explicit rbtree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+
+    }
+    explicit rbtree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    rbtree(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(first, last);
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    rbtree(ForwardIt first, ForwardIt last, thread_pool & pool, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(first, last, pool);
+    }
+    explicit rbtree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator()) : compare(COMPARE), allocator(ALLOCATOR) {
+      assign(list.begin(), list.end());
     }
     rbtree(const rbtree &) = delete;
-    rbtree(rbtree &&) = delete;
+    rbtree(rbtree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), tree_root(other.tree_root), rightmost(other.rightmost), free_list(other.free_list) {
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+    }
     rbtree& operator=(const rbtree &) = delete;
-    rbtree& operator=(rbtree &&) = delete;
+    rbtree& operator=(rbtree && other) {
+      if (this == &other) return *this;
+      clear();
+      compare = std::move(other.compare);
+      if (node_traits::propagate_on_container_move_assignment::value) {
+        allocator = std::move(other.allocator);
+      } else if (allocator != other.allocator) {
+        for (const rbnode * n {other.begin().node}; n; n = next(n)) {
+          rbnode * source {const_cast<rbnode *>(n)};
+          emplace_unique(std::move(source->key), std::move(source->value));
+        }
+        other.clear();
+        return *this;
+      }
+      tree_root = other.tree_root;
+      rightmost = other.rightmost;
+      free_list = other.free_list;
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+      return *this;
+    }
     ~rbtree() {
-      delete tree_root;
+      if (!releases_on_destruction <node_allocator>::value || !std::is_trivially_destructible <rbnode>::value) {
+        clear();
+      }
     }
-    void pre_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      pre_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last) {
+      assign(first, last, nullptr);
     }
-    void in_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      in_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool & pool) {
+      assign(first, last, &pool);
     }
-    void post_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      post_order_traversal(tree_root, handler);
+    template <typename Handler>
+    void pre_order_traversal(Handler handler) {
+      for (const rbnode * current {tree_root}; current; current = pre_order_next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void breadth_first_traversal(void handler(const T & key, const U & value)) noexcept {
-      breadth_first_traversal(tree_root, handler);
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      for (const rbnode * current {begin().node}; current; current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void insert(const T & key, const U & value) noexcept {
-      rbnode * current {tree_root};
-      rbnode * parent {nullptr};
-      while (current != nullptr) {
-        parent = current;
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
-        } else if (key == current->key) {
-          current->value = value;
-          return;
-        }
+    template <typename Handler>
+    void post_order_traversal(Handler handler) {
+      if (!tree_root) return;
+      for (const rbnode * current {post_order_first(tree_root)}; current; current = post_order_next(current)) {
+        if (!visit(handler, current)) return;
       }
-      current = new rbnode(key, value, RED);
-      current->parent = parent;
-      if (!parent) {
-        tree_root = current;
-      } else if (current->key > parent->key) {
-        parent->right = current;
-      } else if (current->key < parent->key) {
-        parent->left = current;
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <const rbnode *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        const rbnode * current {queue.front()};
+        if (!visit(handler, current)) return;
+        queue.pop();
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
       }
-      fix(current);
     }
-    const rbnode * search(const T & key) noexcept {
-      rbnode * current {tree_root};
-      while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
+    template <typename Handler>
+    void parallel_for_each(Handler handler, thread_pool & pool) const {
+      if (tree_root) for_each_subtree(tree_root, handler, &pool);
+    }
+    template <typename R, typename Map, typename Combine>
+    R parallel_reduce(const R & identity, Map map, Combine combine, thread_pool & pool) const {
+      if (!tree_root) return identity;
+      return reduce_subtree(tree_root, identity, map, combine, &pool);
+    }
+    std::pair <iterator, bool> insert(const T & key, const U & value) {
+      return insert_or_assign(key, value);
+    }
+    std::pair <iterator, bool> insert(const T & key, U && value) {
+      return insert_or_assign(key, std::move(value));
+    }
+    std::pair <iterator, bool> insert(T && key, const U & value) {
+      return insert_or_assign(std::move(key), value);
+    }
+    std::pair <iterator, bool> insert(T && key, U && value) {
+      return insert_or_assign(std::move(key), std::move(value));
+    }
+    template <typename V>
+    iterator insert(iterator hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint.node, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(iterator hint, T && key, V && value) {
+      return iterator(assign_hinted(hint.node, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const rbnode * hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const rbnode * hint, T && key, V && value) {
+      return iterator(assign_hinted(hint, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename ForwardIt>
+    void insert_batch(ForwardIt first, ForwardIt last) {
+      std::vector <ForwardIt> elements {gather(first, last, nullptr)};
+      if (elements.size() >= size()) {
+        merge(elements);
+        return;
+      }
+      rbnode * finger {nullptr};
+      for (const ForwardIt & element : elements) {
+        rbnode * parent {nullptr};
+        bool left {false};
+        rbnode * existing {locate(key_of(*element), parent, left, climb(finger, key_of(*element)))};
+        if (existing) {
+          existing->value = value_of(*element);
+          finger = existing;
         } else {
-          return current;
+          finger = create_node(key_of(*element), value_of(*element));
+          link(finger, parent, left);
         }
       }
-      return nullptr;
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(const T & key, V && value) {
+      std::pair <rbnode *, bool> result {assign_unique(key, std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(T && key, V && value) {
+      std::pair <rbnode *, bool> result {assign_unique(std::move(key), std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(const T & key, Args &&... args) {
+      std::pair <rbnode *, bool> result {emplace_unique(key, std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(T && key, Args &&... args) {
+      std::pair <rbnode *, bool> result {emplace_unique(std::move(key), std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> emplace(Args &&... args) {
+      rbnode * n {create_node(std::forward<Args>(args)...)};
+      rbnode * parent {nullptr};
+      bool left {false};
+      rbnode * existing {locate(n->key, parent, left)};
+      if (existing) {
+        recycle_node(n);
+        return {iterator(existing, this), false};
+      }
+      link(n, parent, left);
+      return {iterator(n, this), true};
+    }
+    size_t erase(const T & key) {
+      rbnode * target {find(key)};
+      if (!target) return 0;
+      unlink(target);
+      recycle_node(target);
+      return 1;
+    }
+    std::pair <rbtree, rbtree> split(const T & key) {
+      std::pair <rbtree, rbtree> result {scratch(), scratch()};
+      size_t lesser_height {0};
+      size_t greater_height {0};
+      rbnode * found {split_into(tree_root, black_height(tree_root), key, result.first, lesser_height, result.second, greater_height)};
+      if (found) result.second.join_roots(nullptr, 0, found, result.second.tree_root, greater_height);
+      result.first.update_rightmost();
+      result.second.update_rightmost();
+      tree_root = nullptr;
+      rightmost = nullptr;
+      return result;
+    }
+    template <typename V>
+    static rbtree join(rbtree && left, const T & key, V && value, rbtree && right) {
+      rbnode * middle {left.create_node(key, std::forward<V>(value))};
+      rbtree result {std::move(left)};
+      result.append(middle, right);
+      return result;
+    }
+    static rbtree concat(rbtree && left, rbtree && right) {
+      rbtree result {std::move(left)};
+      result.append(nullptr, right);
+      return result;
+    }
+    void union_with(rbtree && other) {
+      combine_with(UNION, other, nullptr);
+    }
+    void union_with(rbtree && other, thread_pool & pool) {
+      combine_with(UNION, other, &pool);
+    }
+    void intersect_with(rbtree && other) {
+      combine_with(INTERSECTION, other, nullptr);
+    }
+    void intersect_with(rbtree && other, thread_pool & pool) {
+      combine_with(INTERSECTION, other, &pool);
+    }
+    void difference(rbtree && other) {
+      combine_with(DIFFERENCE, other, nullptr);
+    }
+    void difference(rbtree && other, thread_pool & pool) {
+      combine_with(DIFFERENCE, other, &pool);
+    }
+    const rbnode * search(const T & key) {
+      return find(key);
     }
     const rbnode * minimum() noexcept {
       rbnode * current = {tree_root};
@@ -232,64 +1224,149 @@ namespace forest {
       return current;
     }
     const rbnode * maximum() noexcept {
-      rbnode * current {tree_root};
+      return rightmost;
+    }
+    const rbnode * successor(const T & key) {
+      rbnode * current {find(key)};
       if (!current) return nullptr;
-      while (current->right) current = current->right;
-      return current;
+      return next(current);
+    }
+    const rbnode * predecessor(const T & key) {
+      rbnode * current {find(key)};
+      if (!current) return nullptr;
+      return previous(current);
+    }
+    const rbnode * floor(const T & key) {
+      return last_not_greater(key);
+    }
+    const rbnode * ceiling(const T & key) {
+      return first_not_less(key);
+    }
+    iterator lower_bound(const T & key) {
+      return iterator(first_not_less(key), this);
     }
-    const rbnode * successor(const T & key) noexcept {
+    iterator upper_bound(const T & key) {
+      return iterator(first_greater(key), this);
+    }
+    std::pair <iterator, iterator> equal_range(const T & key) {
+      const rbnode * first {first_not_less(key)};
+      const rbnode * last {first && !compare(key, first->key) ? next(first) : first};
+      return {iterator(first, this), iterator(last, this)};
+    }
+    template <typename Handler>
+    void for_each_in_range(const T & lo, const T & hi, Handler handler) {
+      for (const rbnode * current {first_not_less(lo)}; current && compare(current->key, hi); current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
+    }
+    size_t rank(const T & key) {
+      size_t result {0};
       rbnode * current {tree_root};
       while (current) {
-        if (key > current->key) {
+        if (compare(current->key, key)) {
+          result += size(current->left) + 1;
           current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
         } else {
-          if (current->right) {
-            current = current->right;
-            while (current->left) current = current->left;
-            return current;
-          }
-          rbnode * parent {current->parent};
-          while (parent && current == parent->right) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          current = current->left;
         }
       }
-      return nullptr;
+      return result;
     }
-    const rbnode * predecessor(const T & key) {
+    const rbnode * select(size_t index) {
       rbnode * current {tree_root};
       while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
+        size_t left_size {size(current->left)};
+        if (index < left_size) {
           current = current->left;
+        } else if (index > left_size) {
+          index -= left_size + 1;
+          current = current->right;
         } else {
-          if (current->left) {
-            current = current->left;
-            while (current->right) current = current->right;
-            return current;
-          }
-          rbnode * parent {current->parent};
-          while (parent && current == parent->left) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          return current;
         }
       }
       return nullptr;
     }
+    size_t count_range(const T & lo, const T & hi) {
+      size_t lo_rank {rank(lo)};
+      size_t hi_rank {rank(hi)};
+      return hi_rank > lo_rank ? hi_rank - lo_rank : 0;
+    }
+    const rbnode * percentile(double p) {
+      if (!tree_root) return nullptr;
+      size_t n {size(tree_root)};
+      size_t nearest_rank {static_cast<size_t>(std::ceil(std::min(std::max(p, 0.0), 100.0) / 100.0 * n))};
+      return select(nearest_rank ? std::min(nearest_rank, n) - 1 : 0);
+    }
+    template <typename Generator>
+    const rbnode * sample(Generator & generator) {
+      if (!tree_root) return nullptr;
+      std::uniform_int_distribution <size_t> distribution(0, size(tree_root) - 1);
+      return select(distribution(generator));
+    }
+    iterator begin() const noexcept {
+      const rbnode * current {tree_root};
+      if (current) {
+        while (current->left) current = current->left;
+      }
+      return iterator(current, this);
+    }
+    iterator end() const noexcept {
+      return iterator(nullptr, this);
+    }
+    iterator cbegin() const noexcept {
+      return begin();
+    }
+    iterator cend() const noexcept {
+      return end();
+    }
+    reverse_iterator rbegin() const noexcept {
+      return reverse_iterator(end());
+    }
+    reverse_iterator rend() const noexcept {
+      return reverse_iterator(begin());
+    }
+    reverse_iterator crbegin() const noexcept {
+      return rbegin();
+    }
+    reverse_iterator crend() const noexcept {
+      return rend();
+    }
     size_t height() noexcept {
       return height(tree_root);
     }
     size_t size() noexcept {
       return size(tree_root);
     }
-    bool empty() noexcept {
+    void clear() noexcept {
+      destroy_subtree(tree_root);
+      tree_root = nullptr;
+      rightmost = nullptr;
+      release_free_list();
+    }
+    frozen_map <T, U, Compare> freeze() const {
+      return frozen_map <T, U, Compare>(begin(), end(), compare);
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return Allocator(allocator);
+    }
+    void swap(rbtree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      if (node_traits::propagate_on_container_swap::value) {
+        swap(allocator, other.allocator);
+      }
+      swap(tree_root, other.tree_root);
+      swap(rightmost, other.rightmost);
+      swap(free_list, other.free_list);
+    }
+    friend void swap(rbtree & lhs, rbtree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
+    bool empty() const noexcept {
       return !tree_root;
     }
     const rbnode * root() noexcept {
@@ -5,76 +5,334 @@
 
 #pragma once
 
+#include "arena.hpp"
+#include "frozen_map.hpp"
+#include "thread_pool.hpp"
+
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <queue>
+#include <random>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace forest {
-  template <typename T, typename U>
+  class full_splay {
+  public:
+    static constexpr bool semi {false};
+    bool operator()(size_t) const noexcept {
+      return true;
+    }
+  };
+  class semi_splay {
+  public:
+    static constexpr bool semi {true};
+    bool operator()(size_t) const noexcept {
+      return true;
+    }
+  };
+  class probabilistic_splay {
+  public:
+    static constexpr bool semi {false};
+    explicit probabilistic_splay(double PROBABILITY = 0.5, std::minstd_rand::result_type SEED = std::minstd_rand::default_seed) : probability(PROBABILITY), generator(SEED) {
+
+    }
+    bool operator()(size_t) {
+      return distribution(generator) < probability;
+    }
+  private:
+    double probability;
+    std::minstd_rand generator;
+    std::uniform_real_distribution <double> distribution;
+  };
+  class depth_threshold_splay {
+  public:
+    static constexpr bool semi {false};
+    explicit depth_threshold_splay(size_t THRESHOLD = 16) noexcept : threshold(THRESHOLD) {
+
+    }
+    bool operator()(size_t depth) const noexcept {
+      return depth > threshold;
+    }
+  private:
+    size_t threshold;
+  };
+  template <typename T, typename U, typename Compare = std::less <T>, typename Allocator = std::allocator <std::pair <const T, U> >, typename Policy = full_splay>
   class splaytree {
   private:
     class splaynode {
     public:
       splaynode() = default;
-      splaynode(const T & KEY, const U & VALUE) : key(KEY), value(VALUE) {
+      template <typename K, typename... Args>
+      splaynode(K && KEY, Args &&... ARGS) : key(std::forward<K>(KEY)), value(std::forward<Args>(ARGS)...) {
 
       }
       splaynode(const splaynode &) = delete;
       splaynode(splaynode &&) = delete;
       splaynode& operator=(const splaynode &) = delete;
       splaynode& operator=(splaynode &&) = delete;
-      ~splaynode() {
-        delete left;
-        delete right;
-      }
+      ~splaynode() = default;
       T key;
       U value;
       friend class splaytree;
     private:
+      size_t size {1};
       splaynode * parent {nullptr};
       splaynode * left {nullptr};
       splaynode * right {nullptr};
     };
+    using node_allocator = typename std::allocator_traits <Allocator>::template rebind_alloc <splaynode>;
+    using node_traits = std::allocator_traits <node_allocator>;
+    Compare compare;
+    node_allocator allocator;
+    Policy policy;
     splaynode * tree_root {nullptr};
-    void pre_order_traversal(const splaynode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      handler(root->key, root->value);
-      pre_order_traversal(root->left, handler);
-      pre_order_traversal(root->right, handler);
-    }
-    void in_order_traversal(const splaynode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      in_order_traversal(root->left, handler);
-      handler(root->key, root->value);
-      in_order_traversal(root->right, handler);
-    }
-    void post_order_traversal(const splaynode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      post_order_traversal(root->left, handler);
-      post_order_traversal(root->right, handler);
-      handler(root->key, root->value);
-    }
-    void breadth_first_traversal(const splaynode * root, void handler(const T & key, const U & value)) noexcept {
-      if (!root) return;
-      std::queue <const splaynode *> queue;
-      queue.push(root);
-      while (!queue.empty()) {
-        splaynode * root {queue.front()};
-        handler(root->key, root->value);
-        queue.pop();
-        if (root->left) queue.push(root->left);
-        if (root->right) queue.push(root->right);
+    splaynode * rightmost {nullptr};
+    void * free_list {nullptr};
+    static constexpr size_t parallel_grain {4096};
+    template <typename... Args>
+    splaynode * create_node(Args &&... args) {
+      splaynode * storage {static_cast<splaynode *>(free_list)};
+      if (storage) {
+        free_list = *static_cast<void **>(free_list);
+      } else {
+        storage = node_traits::allocate(allocator, 1);
+      }
+      try {
+        node_traits::construct(allocator, storage, std::forward<Args>(args)...);
+      } catch (...) {
+        *reinterpret_cast<void **>(storage) = free_list;
+        free_list = storage;
+        throw;
+      }
+      return storage;
+    }
+    void recycle_node(splaynode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      *reinterpret_cast<void **>(n) = free_list;
+      free_list = n;
+    }
+    void destroy_node(splaynode * n) noexcept {
+      node_traits::destroy(allocator, n);
+      node_traits::deallocate(allocator, n, 1);
+    }
+    void destroy_subtree(splaynode * root) noexcept {
+      splaynode * current {root};
+      while (current) {
+        if (current->left) {
+          current = current->left;
+        } else if (current->right) {
+          current = current->right;
+        } else {
+          splaynode * parent {current == root ? nullptr : current->parent};
+          if (parent && parent->left == current) {
+            parent->left = nullptr;
+          } else if (parent) {
+            parent->right = nullptr;
+          }
+          destroy_node(current);
+          current = parent;
+        }
       }
     }
+    void release_free_list() noexcept {
+      while (free_list) {
+        void * next {*static_cast<void **>(free_list)};
+        node_traits::deallocate(allocator, static_cast<splaynode *>(free_list), 1);
+        free_list = next;
+      }
+    }
+    void transplant(splaynode * u, splaynode * v) noexcept {
+      if (!u->parent) {
+        tree_root = v;
+      } else if (u == u->parent->left) {
+        u->parent->left = v;
+      } else {
+        u->parent->right = v;
+      }
+      if (v) v->parent = u->parent;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const splaynode * n, std::true_type) {
+      handler(n->key, n->value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const splaynode * n, std::false_type) {
+      return static_cast<bool>(handler(n->key, n->value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const splaynode * n) {
+      return visit(handler, n, std::is_void<decltype(handler(n->key, n->value))>());
+    }
+    splaynode * find(const T & key) {
+      splaynode * current {tree_root};
+      splaynode * candidate {nullptr};
+      size_t depth {0};
+      size_t candidate_depth {0};
+      while (current) {
+        if (compare(key, current->key)) {
+          current = current->left;
+        } else {
+          candidate = current;
+          candidate_depth = depth;
+          current = current->right;
+        }
+        depth++;
+      }
+      if (!candidate || compare(candidate->key, key)) return nullptr;
+      if (policy(candidate_depth)) {
+        if (Policy::semi) {
+          semi_fix(candidate);
+        } else {
+          fix(candidate);
+        }
+      }
+      return candidate;
+    }
+    splaynode * last_not_greater(const T & key) {
+      splaynode * current {tree_root};
+      splaynode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      return candidate;
+    }
+    splaynode * first_not_less(const T & key) {
+      splaynode * current {tree_root};
+      splaynode * candidate {nullptr};
+      while (current) {
+        if (compare(current->key, key)) {
+          current = current->right;
+        } else {
+          candidate = current;
+          current = current->left;
+        }
+      }
+      return candidate;
+    }
+    splaynode * first_greater(const T & key) {
+      splaynode * current {tree_root};
+      splaynode * candidate {nullptr};
+      while (current) {
+        if (compare(key, current->key)) {
+          candidate = current;
+          current = current->left;
+        } else {
+          current = current->right;
+        }
+      }
+      return candidate;
+    }
+    splaynode * locate(const T & key, splaynode *& parent, bool & left) {
+      return locate(key, parent, left, tree_root);
+    }
+    splaynode * locate(const T & key, splaynode *& parent, bool & left, splaynode * start) {
+      if (rightmost && compare(rightmost->key, key)) {
+        parent = rightmost;
+        left = false;
+        return nullptr;
+      }
+      splaynode * current {start};
+      splaynode * candidate {nullptr};
+      parent = nullptr;
+      left = false;
+      while (current) {
+        parent = current;
+        left = compare(key, current->key);
+        if (left) {
+          current = current->left;
+        } else {
+          candidate = current;
+          current = current->right;
+        }
+      }
+      if (candidate && !compare(candidate->key, key)) return candidate;
+      return nullptr;
+    }
+    static const splaynode * pre_order_next(const splaynode * n) noexcept {
+      if (n->left) return n->left;
+      if (n->right) return n->right;
+      const splaynode * parent {n->parent};
+      while (parent && (n == parent->right || !parent->right)) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent ? parent->right : nullptr;
+    }
+    static const splaynode * post_order_first(const splaynode * n) noexcept {
+      while (n->left || n->right) n = n->left ? n->left : n->right;
+      return n;
+    }
+    static const splaynode * post_order_next(const splaynode * n) noexcept {
+      const splaynode * parent {n->parent};
+      if (!parent || n == parent->right || !parent->right) return parent;
+      return post_order_first(parent->right);
+    }
+    static const splaynode * next(const splaynode * n) noexcept {
+      if (n->right) {
+        n = n->right;
+        while (n->left) n = n->left;
+        return n;
+      }
+      const splaynode * parent {n->parent};
+      while (parent && n == parent->right) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
+    }
+    static const splaynode * previous(const splaynode * n) noexcept {
+      if (n->left) {
+        n = n->left;
+        while (n->right) n = n->right;
+        return n;
+      }
+      const splaynode * parent {n->parent};
+      while (parent && n == parent->left) {
+        n = parent;
+        parent = parent->parent;
+      }
+      return parent;
+    }
     size_t height(const splaynode * root) noexcept {
-      if (!root) return 0;
-      return std::max(height(root->left), height(root->right)) + 1;
+      size_t result {0};
+      size_t depth {0};
+      const splaynode * previous {nullptr};
+      const splaynode * current {root};
+      while (current) {
+        const splaynode * following {current->parent};
+        if (previous == current->parent) {
+          result = std::max(result, ++depth);
+          if (current->left) {
+            following = current->left;
+          } else if (current->right) {
+            following = current->right;
+          }
+        } else if (previous == current->left && current->right) {
+          following = current->right;
+        }
+        if (following == current->parent) depth--;
+        previous = current;
+        current = following;
+        if (previous == root && current == root->parent) break;
+      }
+      return result;
     }
     size_t size(const splaynode * root) noexcept {
       if (!root) return 0;
-      return size(root->left) + size(root->right) + 1;
+      return root->size;
     }
     void rotate_right(splaynode * rotation_root) noexcept {
       splaynode * new_root {rotation_root->left};
@@ -93,6 +351,8 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
     }
     void rotate_left(splaynode * rotation_root) noexcept {
       splaynode * new_root {rotation_root->right};
@@ -111,6 +371,8 @@ namespace forest {
       }
       new_root->parent = rotation_root->parent;
       rotation_root->parent = new_root;
+      rotation_root->size = size(rotation_root->left) + size(rotation_root->right) + 1;
+      new_root->size = size(new_root->left) + size(new_root->right) + 1;
     }
     void fix(splaynode * n) noexcept {
       while (n->parent) {
@@ -135,69 +397,554 @@ namespace forest {
         }
       }
     }
+    void semi_fix(splaynode * n) noexcept {
+      while (n->parent) {
+        splaynode * parent {n->parent};
+        splaynode * grand_parent {parent->parent};
+        if (!grand_parent) {
+          if (parent->left == n) {
+            rotate_right(parent);
+          } else {
+            rotate_left(parent);
+          }
+        } else if (parent->left == n && grand_parent->left == parent) {
+          rotate_right(grand_parent);
+          n = parent;
+        } else if (parent->right == n && grand_parent->right == parent) {
+          rotate_left(grand_parent);
+          n = parent;
+        } else if (parent->left == n) {
+          rotate_right(parent);
+          rotate_left(grand_parent);
+        } else {
+          rotate_left(parent);
+          rotate_right(grand_parent);
+        }
+      }
+    }
+    void link(splaynode * n, splaynode * parent, bool left) {
+      attach(n, parent, left);
+      fix(n);
+    }
+    void attach(splaynode * n, splaynode * parent, bool left) noexcept {
+      n->parent = parent;
+      if (!parent || (parent == rightmost && !left)) rightmost = n;
+      if (!parent) {
+        tree_root = n;
+      } else if (left) {
+        parent->left = n;
+      } else {
+        parent->right = n;
+      }
+      for (splaynode * ancestor {parent}; ancestor; ancestor = ancestor->parent) {
+        ancestor->size++;
+      }
+    }
+    template <typename K, typename... Args>
+    std::pair <splaynode *, bool> emplace_unique(K && key, Args &&... args) {
+      splaynode * parent {nullptr};
+      bool left {false};
+      splaynode * existing {locate(key, parent, left)};
+      if (existing) return {existing, false};
+      splaynode * n {create_node(std::forward<K>(key), std::forward<Args>(args)...)};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <splaynode *, bool> assign_unique(K && key, V && value) {
+      splaynode * parent {nullptr};
+      bool left {false};
+      splaynode * existing {locate(key, parent, left)};
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      splaynode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename K, typename V>
+    std::pair <splaynode *, bool> assign_hinted(const splaynode * hint, K && key, V && value) {
+      splaynode * position {const_cast<splaynode *>(hint)};
+      splaynode * parent {nullptr};
+      bool left {false};
+      splaynode * existing {nullptr};
+      if (position && compare(key, position->key)) {
+        splaynode * before {const_cast<splaynode *>(previous(position))};
+        if (!before || compare(before->key, key)) {
+          left = !position->left;
+          parent = left ? position : before;
+        } else {
+          existing = locate(key, parent, left);
+        }
+      } else if (position && !compare(position->key, key)) {
+        existing = position;
+      } else {
+        existing = locate(key, parent, left);
+      }
+      if (existing) {
+        existing->value = std::forward<V>(value);
+        return {existing, false};
+      }
+      splaynode * n {create_node(std::forward<K>(key), std::forward<V>(value))};
+      link(n, parent, left);
+      return {n, true};
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.first)) {
+      return element.first;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.key)) {
+      return element.key;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.second)) {
+      return element.second;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.value)) {
+      return element.value;
+    }
+    template <typename ForwardIt>
+    std::vector <ForwardIt> gather(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements;
+      for (ForwardIt it {first}; it != last; ++it) {
+        elements.push_back(it);
+      }
+      auto less = [this](const ForwardIt & lhs, const ForwardIt & rhs) {
+        return compare(key_of(*lhs), key_of(*rhs));
+      };
+      if (!std::is_sorted(elements.begin(), elements.end(), less)) {
+        if (pool) {
+          parallel_stable_sort(elements.begin(), elements.end(), less, *pool);
+        } else {
+          std::stable_sort(elements.begin(), elements.end(), less);
+        }
+      }
+      size_t unique {0};
+      for (size_t i {0}; i < elements.size(); i++) {
+        if (unique && !less(elements[unique - 1], elements[i])) {
+          elements[unique - 1] = elements[i];
+        } else {
+          elements[unique++] = elements[i];
+        }
+      }
+      elements.resize(unique);
+      return elements;
+    }
+    splaynode * climb(splaynode * finger, const T & key) {
+      if (!finger) return tree_root;
+      while (finger->parent && !(finger == finger->parent->left && compare(key, finger->parent->key))) {
+        finger = finger->parent;
+      }
+      return finger;
+    }
+    void relink(const std::vector <splaynode *> & nodes, size_t lo, size_t hi, splaynode * parent, splaynode *& slot) noexcept {
+      if (lo == hi) {
+        slot = nullptr;
+        return;
+      }
+      const size_t middle {lo + (hi - lo) / 2};
+      splaynode * n {nodes[middle]};
+      n->parent = parent;
+      n->size = hi - lo;
+      slot = n;
+      relink(nodes, lo, middle, n, n->left);
+      relink(nodes, middle + 1, hi, n, n->right);
+    }
+    template <typename ForwardIt>
+    void merge(const std::vector <ForwardIt> & elements) {
+      std::vector <splaynode *> nodes;
+      nodes.reserve(size());
+      for (const splaynode * n {begin().node}; n; n = next(n)) {
+        nodes.push_back(const_cast<splaynode *>(n));
+      }
+      std::vector <splaynode *> merged;
+      merged.reserve(nodes.size() + elements.size());
+      std::vector <splaynode *> fresh;
+      fresh.reserve(elements.size());
+      size_t i {0};
+      try {
+        for (const ForwardIt & element : elements) {
+          while (i < nodes.size() && compare(nodes[i]->key, key_of(*element))) {
+            merged.push_back(nodes[i++]);
+          }
+          if (i < nodes.size() && !compare(key_of(*element), nodes[i]->key)) {
+            nodes[i]->value = value_of(*element);
+            merged.push_back(nodes[i++]);
+          } else {
+            fresh.push_back(create_node(key_of(*element), value_of(*element)));
+            merged.push_back(fresh.back());
+          }
+        }
+      } catch (...) {
+        for (splaynode * n : fresh) {
+          recycle_node(n);
+        }
+        throw;
+      }
+      while (i < nodes.size()) {
+        merged.push_back(nodes[i++]);
+      }
+      relink(merged, 0, merged.size(), nullptr, tree_root);
+      rightmost = merged.empty() ? nullptr : merged.back();
+    }
+    template <typename ForwardIt>
+    void build(const std::vector <ForwardIt> & elements, const std::vector <splaynode *> & storage, std::vector <char> & constructed, size_t lo, size_t hi, size_t index, splaynode * parent, splaynode *& slot, thread_pool * pool) {
+      if (lo == hi) return;
+      const size_t middle {lo + (hi - lo) / 2};
+      splaynode * n {storage[index]};
+      node_traits::construct(allocator, n, key_of(*elements[middle]), value_of(*elements[middle]));
+      constructed[index] = true;
+      n->parent = parent;
+      n->size = hi - lo;
+      slot = n;
+      fork(pool, hi - lo, [&] {
+        build(elements, storage, constructed, lo, middle, index + 1, n, n->left, pool);
+      }, [&] {
+        build(elements, storage, constructed, middle + 1, hi, index + 1 + middle - lo, n, n->right, pool);
+      });
+    }
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool * pool) {
+      std::vector <ForwardIt> elements {gather(first, last, pool)};
+      std::vector <char> constructed(elements.size());
+      std::vector <splaynode *> storage;
+      storage.reserve(elements.size());
+      clear();
+      try {
+        while (storage.size() < elements.size()) {
+          storage.push_back(node_traits::allocate(allocator, 1));
+        }
+        build(elements, storage, constructed, 0, elements.size(), 0, nullptr, tree_root, pool);
+      } catch (...) {
+        for (size_t i {0}; i < storage.size(); i++) {
+          if (constructed[i]) node_traits::destroy(allocator, storage[i]);
+          node_traits::deallocate(allocator, storage[i], 1);
+        }
+        tree_root = nullptr;
+        throw;
+      }
+      update_rightmost();
+    }
+    void update_rightmost() noexcept {
+      rightmost = tree_root;
+      while (rightmost && rightmost->right) rightmost = rightmost->right;
+    }
+    template <typename First, typename Second>
+    static void fork(thread_pool * pool, size_t work, First && first, Second && second) {
+      if (pool && work >= parallel_grain) {
+        pool->invoke(first, second);
+      } else {
+        first();
+        second();
+      }
+    }
+    template <typename Handler>
+    static void for_each_subtree(const splaynode * n, Handler & handler, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        const splaynode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          handler(current->key, current->value);
+        }
+        return;
+      }
+      fork(pool, n->size, [&] {
+        if (n->left) for_each_subtree(n->left, handler, pool);
+      }, [&] {
+        handler(n->key, n->value);
+        if (n->right) for_each_subtree(n->right, handler, pool);
+      });
+    }
+    template <typename R, typename Map, typename Combine>
+    static R reduce_subtree(const splaynode * n, const R & identity, Map & map, Combine & combine, thread_pool * pool) {
+      if (!pool || n->size < parallel_grain) {
+        R result {identity};
+        const splaynode * current {n};
+        while (current->left) current = current->left;
+        for (size_t i {0}; i < n->size; i++, current = next(current)) {
+          result = combine(std::move(result), map(current->key, current->value));
+        }
+        return result;
+      }
+      R left {identity};
+      R right {identity};
+      fork(pool, n->size, [&] {
+        if (n->left) left = reduce_subtree(n->left, identity, map, combine, pool);
+      }, [&] {
+        if (n->right) right = reduce_subtree(n->right, identity, map, combine, pool);
+      });
+      return combine(combine(std::move(left), map(n->key, n->value)), std::move(right));
+    }
   public:
-    splaytree() = default;
-    explicit splaytree(std::initializer_list <std::pair <T, U> > list) {
-      for (auto element : list) {
-        insert(element.first, element.second);
+    class iterator {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = splaynode;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const splaynode *;
+      using reference = const splaynode &;
+      iterator() = default;
+      reference operator*() const noexcept {
+        return *node;
+      }
+      pointer operator->() const noexcept {
+        return node;
+      }
+      iterator & operator++() noexcept {
+        node = next(node);
+        return *this;
+      }
+      iterator operator++(int) noexcept {
+        iterator result {*this};
+        ++*this;
+        return result;
+      }
+      iterator & operator--() noexcept {
+        if (node) {
+          node = previous(node);
+        } else {
+          node = tree->rightmost;
+        }
+        return *this;
+      }
+      iterator operator--(int) noexcept {
+        iterator result {*this};
+        --*this;
+        return result;
       }
+      friend bool operator==(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node == rhs.node;
+      }
+      friend bool operator!=(const iterator & lhs, const iterator & rhs) noexcept {
+        return lhs.node != rhs.node;
+      }
+    private:
+      iterator(const splaynode * NODE, const splaytree * TREE) : node(NODE), tree(TREE) {
+
+      }
+      const splaynode * node {nullptr};
+      const splaytree * tree {nullptr};
+      friend class splaytree;
+    };
+    using const_iterator = iterator;
+    using reverse_iterator = std::reverse_iterator <iterator>;
+    using const_reverse_iterator = reverse_iterator;
+    splaytree() = default;
+    explicit splaytree(const Compare & COMPARE, const Allocator & ALLOCATOR = Allocator(), const Policy & POLICY = Policy()) : compare(COMPARE), allocator(ALLOCATOR), policy(POLICY) {
+
+    }
+    explicit splaytree(const Allocator & ALLOCATOR) : allocator(ALLOCATOR) {
+
+    }
+    explicit splaytree(const Policy & POLICY) : policy(POLICY) {
+
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    splaytree(ForwardIt first, ForwardIt last, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator(), const Policy & POLICY = Policy()) : compare(COMPARE), allocator(ALLOCATOR), policy(POLICY) {
+      assign(first, last);
+    }
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    splaytree(ForwardIt first, ForwardIt last, thread_pool & pool, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator(), const Policy & POLICY = Policy()) : compare(COMPARE), allocator(ALLOCATOR), policy(POLICY) {
+      assign(first, last, pool);
+    }
+    explicit splaytree(std::initializer_list <std::pair <T, U> > list, const Compare & COMPARE = Compare(), const Allocator & ALLOCATOR = Allocator(), const Policy & POLICY = Policy()) : compare(COMPARE), allocator(ALLOCATOR), policy(POLICY) {
+      assign(list.begin(), list.end());
     }
     splaytree(const splaytree &) = delete;
-    splaytree(splaytree &&) = delete;
+    splaytree(splaytree && other) noexcept : compare(std::move(other.compare)), allocator(std::move(other.allocator)), policy(std::move(other.policy)), tree_root(other.tree_root), rightmost(other.rightmost), free_list(other.free_list) {
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+    }
     splaytree& operator=(const splaytree &) = delete;
-    splaytree& operator=(splaytree &&) = delete;
+    splaytree& operator=(splaytree && other) {
+      if (this == &other) return *this;
+      clear();
+      compare = std::move(other.compare);
+      policy = std::move(other.policy);
+      if (node_traits::propagate_on_container_move_assignment::value) {
+        allocator = std::move(other.allocator);
+      } else if (allocator != other.allocator) {
+        for (const splaynode * n {other.begin().node}; n; n = next(n)) {
+          splaynode * source {const_cast<splaynode *>(n)};
+          emplace_unique(std::move(source->key), std::move(source->value));
+        }
+        other.clear();
+        return *this;
+      }
+      tree_root = other.tree_root;
+      rightmost = other.rightmost;
+      free_list = other.free_list;
+      other.tree_root = nullptr;
+      other.rightmost = nullptr;
+      other.free_list = nullptr;
+      return *this;
+    }
     ~splaytree() {
-      delete tree_root;
+      if (!releases_on_destruction <node_allocator>::value || !std::is_trivially_destructible <splaynode>::value) {
+        clear();
+      }
     }
-    void pre_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      pre_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last) {
+      assign(first, last, nullptr);
     }
-    void in_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      in_order_traversal(tree_root, handler);
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last, thread_pool & pool) {
+      assign(first, last, &pool);
     }
-    void post_order_traversal(void handler(const T & key, const U & value)) noexcept {
-      post_order_traversal(tree_root, handler);
+    template <typename Handler>
+    void pre_order_traversal(Handler handler) {
+      for (const splaynode * current {tree_root}; current; current = pre_order_next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void breadth_first_traversal(void handler(const T & key, const U & value)) noexcept {
-      breadth_first_traversal(tree_root, handler);
+    template <typename Handler>
+    void in_order_traversal(Handler handler) {
+      for (const splaynode * current {begin().node}; current; current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
     }
-    void insert(const T & key, const U & value) noexcept {
-      splaynode * current {tree_root};
-      splaynode * parent {nullptr};
-      while (current) {
-        parent = current;
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
-        } else if (key == current->key) {
-          current->value = value;
-          return;
-        }
+    template <typename Handler>
+    void post_order_traversal(Handler handler) {
+      if (!tree_root) return;
+      for (const splaynode * current {post_order_first(tree_root)}; current; current = post_order_next(current)) {
+        if (!visit(handler, current)) return;
       }
-      current = new splaynode(key, value);
-      current->parent = parent;
-      if (!parent) {
-        tree_root = current;
-      } else if (current->key > parent->key) {
-        parent->right = current;
-      } else if (current->key < parent->key) {
-        parent->left = current;
+    }
+    template <typename Handler>
+    void breadth_first_traversal(Handler handler) {
+      std::queue <const splaynode *> queue;
+      if (!tree_root) return;
+      queue.push(tree_root);
+      while (!queue.empty()) {
+        const splaynode * current {queue.front()};
+        if (!visit(handler, current)) return;
+        queue.pop();
+        if (current->left) queue.push(current->left);
+        if (current->right) queue.push(current->right);
       }
-      fix(current);
     }
-    const splaynode * search(const T & key) noexcept {
-      splaynode * current {tree_root};
-      while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
+    template <typename Handler>
+    void parallel_for_each(Handler handler, thread_pool & pool) const {
+      if (tree_root) for_each_subtree(tree_root, handler, &pool);
+    }
+    template <typename R, typename Map, typename Combine>
+    R parallel_reduce(const R & identity, Map map, Combine combine, thread_pool & pool) const {
+      if (!tree_root) return identity;
+      return reduce_subtree(tree_root, identity, map, combine, &pool);
+    }
+    std::pair <iterator, bool> insert(const T & key, const U & value) {
+      return insert_or_assign(key, value);
+    }
+    std::pair <iterator, bool> insert(const T & key, U && value) {
+      return insert_or_assign(key, std::move(value));
+    }
+    std::pair <iterator, bool> insert(T && key, const U & value) {
+      return insert_or_assign(std::move(key), value);
+    }
+    std::pair <iterator, bool> insert(T && key, U && value) {
+      return insert_or_assign(std::move(key), std::move(value));
+    }
+    template <typename V>
+    iterator insert(iterator hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint.node, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(iterator hint, T && key, V && value) {
+      return iterator(assign_hinted(hint.node, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const splaynode * hint, const T & key, V && value) {
+      return iterator(assign_hinted(hint, key, std::forward<V>(value)).first, this);
+    }
+    template <typename V>
+    iterator insert(const splaynode * hint, T && key, V && value) {
+      return iterator(assign_hinted(hint, std::move(key), std::forward<V>(value)).first, this);
+    }
+    template <typename ForwardIt>
+    void insert_batch(ForwardIt first, ForwardIt last) {
+      std::vector <ForwardIt> elements {gather(first, last, nullptr)};
+      if (elements.size() >= size()) {
+        merge(elements);
+        return;
+      }
+      splaynode * finger {nullptr};
+      for (const ForwardIt & element : elements) {
+        splaynode * parent {nullptr};
+        bool left {false};
+        splaynode * existing {locate(key_of(*element), parent, left, climb(finger, key_of(*element)))};
+        if (existing) {
+          existing->value = value_of(*element);
+          finger = existing;
         } else {
-          return current;
+          finger = create_node(key_of(*element), value_of(*element));
+          attach(finger, parent, left);
         }
       }
-      return nullptr;
+      if (finger) fix(finger);
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(const T & key, V && value) {
+      std::pair <splaynode *, bool> result {assign_unique(key, std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename V>
+    std::pair <iterator, bool> insert_or_assign(T && key, V && value) {
+      std::pair <splaynode *, bool> result {assign_unique(std::move(key), std::forward<V>(value))};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(const T & key, Args &&... args) {
+      std::pair <splaynode *, bool> result {emplace_unique(key, std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> try_emplace(T && key, Args &&... args) {
+      std::pair <splaynode *, bool> result {emplace_unique(std::move(key), std::forward<Args>(args)...)};
+      return {iterator(result.first, this), result.second};
+    }
+    template <typename... Args>
+    std::pair <iterator, bool> emplace(Args &&... args) {
+      splaynode * n {create_node(std::forward<Args>(args)...)};
+      splaynode * parent {nullptr};
+      bool left {false};
+      splaynode * existing {locate(n->key, parent, left)};
+      if (existing) {
+        recycle_node(n);
+        return {iterator(existing, this), false};
+      }
+      link(n, parent, left);
+      return {iterator(n, this), true};
+    }
+    size_t erase(const T & key) {
+      splaynode * target {find(key)};
+      if (!target) return 0;
+      if (target == rightmost) rightmost = const_cast<splaynode *>(previous(target));
+      fix(target);
+      splaynode * left_subtree {target->left};
+      splaynode * right_subtree {target->right};
+      if (left_subtree) left_subtree->parent = nullptr;
+      if (right_subtree) right_subtree->parent = nullptr;
+      if (!left_subtree) {
+        tree_root = right_subtree;
+      } else {
+        tree_root = left_subtree;
+        splaynode * predecessor {left_subtree};
+        while (predecessor->right) predecessor = predecessor->right;
+        fix(predecessor);
+        predecessor->right = right_subtree;
+        if (right_subtree) right_subtree->parent = predecessor;
+        predecessor->size += size(right_subtree);
+      }
+      recycle_node(target);
+      return 1;
+    }
+    const splaynode * search(const T & key) {
+      return find(key);
     }
     const splaynode * minimum() noexcept {
       splaynode * current {tree_root};
@@ -206,63 +953,149 @@ namespace forest {
       return current;
     }
     const splaynode * maximum() noexcept {
-      splaynode * current {tree_root};
+      return rightmost;
+    }
+    const splaynode * successor(const T & key) {
+      splaynode * current {find(key)};
       if (!current) return nullptr;
-      while (current->right) current = current->right;
-      return current;
+      return next(current);
+    }
+    const splaynode * predecessor(const T & key) {
+      splaynode * current {find(key)};
+      if (!current) return nullptr;
+      return previous(current);
+    }
+    const splaynode * floor(const T & key) {
+      return last_not_greater(key);
+    }
+    const splaynode * ceiling(const T & key) {
+      return first_not_less(key);
     }
-    const splaynode * successor(const T & key) noexcept {
+    iterator lower_bound(const T & key) {
+      return iterator(first_not_less(key), this);
+    }
+    iterator upper_bound(const T & key) {
+      return iterator(first_greater(key), this);
+    }
+    std::pair <iterator, iterator> equal_range(const T & key) {
+      const splaynode * first {first_not_less(key)};
+      const splaynode * last {first && !compare(key, first->key) ? next(first) : first};
+      return {iterator(first, this), iterator(last, this)};
+    }
+    template <typename Handler>
+    void for_each_in_range(const T & lo, const T & hi, Handler handler) {
+      for (const splaynode * current {first_not_less(lo)}; current && compare(current->key, hi); current = next(current)) {
+        if (!visit(handler, current)) return;
+      }
+    }
+    size_t rank(const T & key) {
+      size_t result {0};
       splaynode * current {tree_root};
       while (current) {
-        if (key > current->key) {
+        if (compare(current->key, key)) {
+          result += size(current->left) + 1;
           current = current->right;
-        } else if (key < current->key) {
-          current = current->left;
         } else {
-          if (current->right) {
-            current = current->right;
-            while (current->left) current = current->left;
-            return current;
-          }
-          splaynode * parent {current->parent};
-          while (parent && current == parent->right) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          current = current->left;
         }
       }
-      return nullptr;
+      return result;
     }
-    const splaynode * predecessor(const T & key) noexcept {
+    const splaynode * select(size_t index) {
       splaynode * current {tree_root};
       while (current) {
-        if (key > current->key) {
-          current = current->right;
-        } else if (key < current->key) {
+        size_t left_size {size(current->left)};
+        if (index < left_size) {
           current = current->left;
+        } else if (index > left_size) {
+          index -= left_size + 1;
+          current = current->right;
         } else {
-          if (current->left) {
-            current = current->left;
-            while (current->right) current = current->right;
-            return current;
-          }
-          splaynode * parent {current->parent};
-          while (parent && current == parent->left) {
-            current = parent;
-            parent = parent->parent;
-          }
-          return parent;
+          return current;
         }
       }
       return nullptr;
     }
+    size_t count_range(const T & lo, const T & hi) {
+      size_t lo_rank {rank(lo)};
+      size_t hi_rank {rank(hi)};
+      return hi_rank > lo_rank ? hi_rank - lo_rank : 0;
+    }
+    const splaynode * percentile(double p) {
+      if (!tree_root) return nullptr;
+      size_t n {size(tree_root)};
+      size_t nearest_rank {static_cast<size_t>(std::ceil(std::min(std::max(p, 0.0), 100.0) / 100.0 * n))};
+      return select(nearest_rank ? std::min(nearest_rank, n) - 1 : 0);
+    }
+    template <typename Generator>
+    const splaynode * sample(Generator & generator) {
+      if (!tree_root) return nullptr;
+      std::uniform_int_distribution <size_t> distribution(0, size(tree_root) - 1);
+      return select(distribution(generator));
+    }
+    iterator begin() const noexcept {
+      const splaynode * current {tree_root};
+      if (current) {
+        while (current->left) current = current->left;
+      }
+      return iterator(current, this);
+    }
+    iterator end() const noexcept {
+      return iterator(nullptr, this);
+    }
+    iterator cbegin() const noexcept {
+      return begin();
+    }
+    iterator cend() const noexcept {
+      return end();
+    }
+    reverse_iterator rbegin() const noexcept {
+      return reverse_iterator(end());
+    }
+    reverse_iterator rend() const noexcept {
+      return reverse_iterator(begin());
+    }
+    reverse_iterator crbegin() const noexcept {
+      return rbegin();
+    }
+    reverse_iterator crend() const noexcept {
+      return rend();
+    }
     size_t height() noexcept {
       return height(tree_root);
     }
     size_t size() noexcept {
       return size(tree_root);
     }
+    void clear() noexcept {
+      destroy_subtree(tree_root);
+      tree_root = nullptr;
+      rightmost = nullptr;
+      release_free_list();
+    }
+    frozen_map <T, U, Compare> freeze() const {
+      return frozen_map <T, U, Compare>(begin(), end(), compare);
+    }
+    Compare key_comp() const {
+      return compare;
+    }
+    Allocator get_allocator() const noexcept {
+      return Allocator(allocator);
+    }
+    void swap(splaytree & other) noexcept {
+      using std::swap;
+      swap(compare, other.compare);
+      swap(policy, other.policy);
+      if (node_traits::propagate_on_container_swap::value) {
+        swap(allocator, other.allocator);
+      }
+      swap(tree_root, other.tree_root);
+      swap(rightmost, other.rightmost);
+      swap(free_list, other.free_list);
+    }
+    friend void swap(splaytree & lhs, splaytree & rhs) noexcept {
+      lhs.swap(rhs);
+    }
     bool empty() const noexcept {
       return !tree_root;
     }
@@ -0,0 +1,349 @@
+/**
+ * @file static_index.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#define FOREST_AVX2
+#endif
+#if defined(__AVX__)
+#define FOREST_AVX
+#endif
+#if defined(__SSE4_2__)
+#define FOREST_SSE42
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FOREST_SSE2
+#endif
+#if defined(FOREST_SSE2) || defined(FOREST_AVX)
+#include <immintrin.h>
+#endif
+
+namespace forest {
+  template <typename T, typename U>
+  class static_index {
+    static_assert(std::is_arithmetic <T>::value, "static_index requires arithmetic keys");
+  public:
+    class element {
+    public:
+      const T & key;
+      const U & value;
+      const element * operator->() const noexcept {
+        return this;
+      }
+    };
+    class element_pointer {
+    public:
+      element_pointer() = default;
+      element_pointer(std::nullptr_t) noexcept {
+
+      }
+      element operator*() const noexcept {
+        return {index->keys()[slot], index->values[slot]};
+      }
+      element operator->() const noexcept {
+        return **this;
+      }
+      explicit operator bool() const noexcept {
+        return index != nullptr;
+      }
+      friend bool operator==(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return lhs.index == rhs.index && lhs.slot == rhs.slot;
+      }
+      friend bool operator!=(const element_pointer & lhs, const element_pointer & rhs) noexcept {
+        return !(lhs == rhs);
+      }
+      friend bool operator==(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return !lhs.index;
+      }
+      friend bool operator!=(const element_pointer & lhs, std::nullptr_t) noexcept {
+        return lhs.index;
+      }
+      friend bool operator==(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return !rhs.index;
+      }
+      friend bool operator!=(std::nullptr_t, const element_pointer & rhs) noexcept {
+        return rhs.index;
+      }
+    private:
+      element_pointer(const static_index * INDEX, size_t SLOT) noexcept : index(INDEX), slot(SLOT) {
+
+      }
+      const static_index * index {nullptr};
+      size_t slot {0};
+      friend class static_index;
+    };
+  private:
+    enum class kernel {
+      SCALAR,
+      INT32,
+      INT64,
+      FLOAT,
+      DOUBLE
+    };
+    static constexpr kernel selected {
+      std::is_same <T, float>::value ? kernel::FLOAT :
+      std::is_same <T, double>::value ? kernel::DOUBLE :
+      std::is_integral <T>::value && std::is_signed <T>::value && sizeof(T) == 4 ? kernel::INT32 :
+      std::is_integral <T>::value && std::is_signed <T>::value && sizeof(T) == 8 ? kernel::INT64 :
+      kernel::SCALAR
+    };
+    static constexpr size_t block {sizeof(T) < 64 ? 64 / sizeof(T) : 1};
+    std::vector <T> storage;
+    std::vector <size_t> layers;
+    std::vector <U> values;
+    size_t offset {0};
+    static T padding() noexcept {
+      return std::numeric_limits <T>::has_infinity ? std::numeric_limits <T>::infinity() : std::numeric_limits <T>::max();
+    }
+    static size_t trailing_ones(unsigned mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<size_t>(__builtin_ctz(~mask));
+#else
+      size_t result {0};
+      while (mask & 1) {
+        mask >>= 1;
+        result++;
+      }
+      return result;
+#endif
+    }
+    static size_t rank(const T * keys, T key, std::integral_constant <kernel, kernel::SCALAR>) noexcept {
+      size_t result {0};
+      for (size_t i {0}; i < block; i++) {
+        result += keys[i] < key;
+      }
+      return result;
+    }
+    static size_t rank(const T * keys, T key, std::integral_constant <kernel, kernel::INT32>) noexcept {
+#if defined(FOREST_AVX2)
+      const __m256i probe {_mm256_set1_epi32(static_cast<int>(key))};
+      const __m256i lo {_mm256_cmpgt_epi32(probe, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys)))};
+      const __m256i hi {_mm256_cmpgt_epi32(probe, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + 8)))};
+      const unsigned mask {static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lo))) | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hi))) << 8};
+      return trailing_ones(mask);
+#elif defined(FOREST_SSE2)
+      const __m128i probe {_mm_set1_epi32(static_cast<int>(key))};
+      unsigned mask {0};
+      for (size_t i {0}; i < 4; i++) {
+        const __m128i less {_mm_cmpgt_epi32(probe, _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + 4 * i)))};
+        mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(less))) << (4 * i);
+      }
+      return trailing_ones(mask);
+#else
+      return rank(keys, key, std::integral_constant <kernel, kernel::SCALAR>());
+#endif
+    }
+    static size_t rank(const T * keys, T key, std::integral_constant <kernel, kernel::INT64>) noexcept {
+#if defined(FOREST_AVX2)
+      const __m256i probe {_mm256_set1_epi64x(static_cast<long long>(key))};
+      const __m256i lo {_mm256_cmpgt_epi64(probe, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys)))};
+      const __m256i hi {_mm256_cmpgt_epi64(probe, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + 4)))};
+      const unsigned mask {static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lo))) | static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hi))) << 4};
+      return trailing_ones(mask);
+#elif defined(FOREST_SSE42)
+      const __m128i probe {_mm_set1_epi64x(static_cast<long long>(key))};
+      unsigned mask {0};
+      for (size_t i {0}; i < 4; i++) {
+        const __m128i less {_mm_cmpgt_epi64(probe, _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + 2 * i)))};
+        mask |= static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(less))) << (2 * i);
+      }
+      return trailing_ones(mask);
+#else
+      return rank(keys, key, std::integral_constant <kernel, kernel::SCALAR>());
+#endif
+    }
+    static size_t rank(const T * keys, T key, std::integral_constant <kernel, kernel::FLOAT>) noexcept {
+#if defined(FOREST_AVX)
+      const __m256 probe {_mm256_set1_ps(static_cast<float>(key))};
+      const __m256 lo {_mm256_cmp_ps(_mm256_loadu_ps(reinterpret_cast<const float *>(keys)), probe, _CMP_LT_OQ)};
+      const __m256 hi {_mm256_cmp_ps(_mm256_loadu_ps(reinterpret_cast<const float *>(keys + 8)), probe, _CMP_LT_OQ)};
+      const unsigned mask {static_cast<unsigned>(_mm256_movemask_ps(lo)) | static_cast<unsigned>(_mm256_movemask_ps(hi)) << 8};
+      return trailing_ones(mask);
+#elif defined(FOREST_SSE2)
+      const __m128 probe {_mm_set1_ps(static_cast<float>(key))};
+      unsigned mask {0};
+      for (size_t i {0}; i < 4; i++) {
+        const __m128 less {_mm_cmplt_ps(_mm_loadu_ps(reinterpret_cast<const float *>(keys + 4 * i)), probe)};
+        mask |= static_cast<unsigned>(_mm_movemask_ps(less)) << (4 * i);
+      }
+      return trailing_ones(mask);
+#else
+      return rank(keys, key, std::integral_constant <kernel, kernel::SCALAR>());
+#endif
+    }
+    static size_t rank(const T * keys, T key, std::integral_constant <kernel, kernel::DOUBLE>) noexcept {
+#if defined(FOREST_AVX)
+      const __m256d probe {_mm256_set1_pd(static_cast<double>(key))};
+      const __m256d lo {_mm256_cmp_pd(_mm256_loadu_pd(reinterpret_cast<const double *>(keys)), probe, _CMP_LT_OQ)};
+      const __m256d hi {_mm256_cmp_pd(_mm256_loadu_pd(reinterpret_cast<const double *>(keys + 4)), probe, _CMP_LT_OQ)};
+      const unsigned mask {static_cast<unsigned>(_mm256_movemask_pd(lo)) | static_cast<unsigned>(_mm256_movemask_pd(hi)) << 4};
+      return trailing_ones(mask);
+#elif defined(FOREST_SSE2)
+      const __m128d probe {_mm_set1_pd(static_cast<double>(key))};
+      unsigned mask {0};
+      for (size_t i {0}; i < 4; i++) {
+        const __m128d less {_mm_cmplt_pd(_mm_loadu_pd(reinterpret_cast<const double *>(keys + 2 * i)), probe)};
+        mask |= static_cast<unsigned>(_mm_movemask_pd(less)) << (2 * i);
+      }
+      return trailing_ones(mask);
+#else
+      return rank(keys, key, std::integral_constant <kernel, kernel::SCALAR>());
+#endif
+    }
+    T * keys() noexcept {
+      return storage.data() + offset;
+    }
+    const T * keys() const noexcept {
+      return storage.data() + offset;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.first)) {
+      return element.first;
+    }
+    template <typename E>
+    static auto key_of(const E & element) noexcept -> decltype((element.key)) {
+      return element.key;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.second)) {
+      return element.second;
+    }
+    template <typename E>
+    static auto value_of(const E & element) noexcept -> decltype((element.value)) {
+      return element.value;
+    }
+    template <typename ForwardIt>
+    void build(ForwardIt first, ForwardIt last) {
+      std::vector <ForwardIt> elements;
+      for (ForwardIt it {first}; it != last; ++it) {
+        elements.push_back(it);
+      }
+      auto less = [](const ForwardIt & lhs, const ForwardIt & rhs) {
+        return key_of(*lhs) < key_of(*rhs);
+      };
+      if (!std::is_sorted(elements.begin(), elements.end(), less)) {
+        std::stable_sort(elements.begin(), elements.end(), less);
+      }
+      size_t unique {0};
+      for (size_t i {0}; i < elements.size(); i++) {
+        if (unique && !less(elements[unique - 1], elements[i])) {
+          elements[unique - 1] = elements[i];
+        } else {
+          elements[unique++] = elements[i];
+        }
+      }
+      elements.resize(unique);
+      if (elements.empty()) return;
+      const size_t n {elements.size()};
+      size_t total {0};
+      for (size_t count {n}; ; count = ((count + block - 1) / block + block) / (block + 1) * block) {
+        layers.push_back(total);
+        total += (count + block - 1) / block * block;
+        if (count <= block) break;
+      }
+      storage.assign(total + block, padding());
+      const size_t misalignment {reinterpret_cast<std::uintptr_t>(storage.data()) % 64};
+      offset = misalignment ? (64 - misalignment) / sizeof(T) % block : 0;
+      T * data {keys()};
+      values.reserve(n);
+      for (size_t i {0}; i < n; i++) {
+        data[i] = key_of(*elements[i]);
+        values.push_back(value_of(*elements[i]));
+      }
+      for (size_t h {1}; h < layers.size(); h++) {
+        const size_t size {(h + 1 < layers.size() ? layers[h + 1] : total) - layers[h]};
+        for (size_t i {0}; i < size; i++) {
+          size_t k {i / block * (block + 1) + i % block + 1};
+          for (size_t l {1}; l < h; l++) {
+            k *= block + 1;
+          }
+          if (k * block < n) data[layers[h] + i] = data[k * block];
+        }
+      }
+    }
+    size_t first_not_less(T key) const noexcept {
+      const T * data {keys()};
+      size_t k {0};
+      for (size_t h {layers.size() - 1}; h > 0; h--) {
+        const size_t i {rank(data + layers[h] + k, key, std::integral_constant <kernel, selected>())};
+        k = k * (block + 1) + i * block;
+      }
+      return k + rank(data + k, key, std::integral_constant <kernel, selected>());
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value, std::true_type) {
+      handler(key, value);
+      return true;
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value, std::false_type) {
+      return static_cast<bool>(handler(key, value));
+    }
+    template <typename Handler>
+    static bool visit(Handler & handler, const T & key, const U & value) {
+      return visit(handler, key, value, std::is_void<decltype(handler(key, value))>());
+    }
+  public:
+    static_index() = default;
+    template <typename ForwardIt, typename = typename std::iterator_traits <ForwardIt>::iterator_category>
+    static_index(ForwardIt first, ForwardIt last) {
+      build(first, last);
+    }
+    explicit static_index(std::initializer_list <std::pair <T, U> > list) {
+      build(list.begin(), list.end());
+    }
+    static_index(const static_index &) = delete;
+    static_index(static_index &&) = default;
+    static_index& operator=(const static_index &) = delete;
+    static_index& operator=(static_index &&) = default;
+    ~static_index() = default;
+    template <typename Handler>
+    void in_order_traversal(Handler handler) const {
+      for (size_t i {0}; i < values.size(); i++) {
+        if (!visit(handler, keys()[i], values[i])) return;
+      }
+    }
+    element_pointer search(T key) const noexcept {
+      if (values.empty()) return nullptr;
+      const size_t slot {first_not_less(key)};
+      if (slot >= values.size() || key < keys()[slot]) return nullptr;
+      return element_pointer(this, slot);
+    }
+    element_pointer lower_bound(T key) const noexcept {
+      if (values.empty()) return nullptr;
+      const size_t slot {first_not_less(key)};
+      if (slot >= values.size()) return nullptr;
+      return element_pointer(this, slot);
+    }
+    element_pointer ceiling(T key) const noexcept {
+      return lower_bound(key);
+    }
+    element_pointer minimum() const noexcept {
+      if (values.empty()) return nullptr;
+      return element_pointer(this, 0);
+    }
+    element_pointer maximum() const noexcept {
+      if (values.empty()) return nullptr;
+      return element_pointer(this, values.size() - 1);
+    }
+    size_t size() const noexcept {
+      return values.size();
+    }
+    bool empty() const noexcept {
+      return values.empty();
+    }
+  };
+}
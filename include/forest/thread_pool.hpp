@@ -0,0 +1,124 @@
+/**
+ * @file thread_pool.hpp
+ * @author George Fotopoulos
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace forest {
+  class thread_pool {
+  private:
+    std::vector <std::thread> workers;
+    std::deque <std::function <void()> > tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping {false};
+    void work() {
+      std::unique_lock <std::mutex> lock(mutex);
+      while (true) {
+        condition.wait(lock, [this] {
+          return stopping || !tasks.empty();
+        });
+        if (tasks.empty()) return;
+        std::function <void()> task {std::move(tasks.front())};
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+      }
+    }
+  public:
+    explicit thread_pool(size_t threads = std::max(std::thread::hardware_concurrency(), 1u)) {
+      for (size_t i {0}; i < threads; i++) {
+        workers.emplace_back([this] {
+          work();
+        });
+      }
+    }
+    thread_pool(const thread_pool &) = delete;
+    thread_pool(thread_pool &&) = delete;
+    thread_pool& operator=(const thread_pool &) = delete;
+    thread_pool& operator=(thread_pool &&) = delete;
+    ~thread_pool() {
+      {
+        std::lock_guard <std::mutex> lock(mutex);
+        stopping = true;
+      }
+      condition.notify_all();
+      for (std::thread & worker : workers) {
+        worker.join();
+      }
+    }
+    template <typename First, typename Second>
+    void invoke(First && first, Second && second) {
+      bool done {false};
+      std::exception_ptr second_error;
+      {
+        std::lock_guard <std::mutex> lock(mutex);
+        tasks.emplace_back([&] {
+          std::exception_ptr error;
+          try {
+            second();
+          } catch (...) {
+            error = std::current_exception();
+          }
+          std::lock_guard <std::mutex> lock(mutex);
+          second_error = error;
+          done = true;
+          condition.notify_all();
+        });
+      }
+      condition.notify_one();
+      std::exception_ptr first_error;
+      try {
+        first();
+      } catch (...) {
+        first_error = std::current_exception();
+      }
+      std::unique_lock <std::mutex> lock(mutex);
+      while (!done) {
+        if (tasks.empty()) {
+          condition.wait(lock);
+          continue;
+        }
+        std::function <void()> task {std::move(tasks.back())};
+        tasks.pop_back();
+        lock.unlock();
+        task();
+        lock.lock();
+      }
+      lock.unlock();
+      if (first_error) std::rethrow_exception(first_error);
+      if (second_error) std::rethrow_exception(second_error);
+    }
+    size_t size() const noexcept {
+      return workers.size();
+    }
+  };
+
+  template <typename RandomIt, typename Compare>
+  void parallel_stable_sort(RandomIt first, RandomIt last, Compare compare, thread_pool & pool) {
+    if (last - first <= 16384) {
+      std::stable_sort(first, last, compare);
+      return;
+    }
+    RandomIt middle {first + (last - first) / 2};
+    pool.invoke([&] {
+      parallel_stable_sort(first, middle, compare, pool);
+    }, [&] {
+      parallel_stable_sort(middle, last, compare, pool);
+    });
+    std::inplace_merge(first, middle, last, compare);
+  }
+}
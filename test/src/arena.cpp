@@ -0,0 +1,104 @@
+/*
+ * @file arena.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/arena.hpp>
+#include <forest/avltree.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/splaytree.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+SCENARIO("Test Arena") {
+  GIVEN("An Arena") {
+    forest::arena arena(256);
+    WHEN("Memory is allocated") {
+      void * first {arena.allocate(24, 8)};
+      void * second {arena.allocate(24, 8)};
+      THEN("Test allocations are distinct") {
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        REQUIRE(first != second);
+      }
+      THEN("Test allocations are contiguous") {
+        REQUIRE(static_cast<char *>(second) - static_cast<char *>(first) == 24);
+      }
+      THEN("Test deallocated memory is reused") {
+        arena.deallocate(first, 24, 8);
+        REQUIRE(arena.allocate(24, 8) == first);
+      }
+    }
+    WHEN("Memory with a large alignment is allocated") {
+      arena.allocate(1, 1);
+      void * result {arena.allocate(64, 64)};
+      THEN("Test alignment") {
+        REQUIRE(reinterpret_cast<std::uintptr_t>(result) % 64 == 0);
+      }
+    }
+    WHEN("Memory larger than a chunk is allocated") {
+      char * result {static_cast<char *>(arena.allocate(4096, 8))};
+      THEN("Test the whole block is usable") {
+        result[0] = 'a';
+        result[4095] = 'z';
+        REQUIRE(result[0] == 'a');
+        REQUIRE(result[4095] == 'z');
+      }
+    }
+  }
+}
+
+SCENARIO("Test Trees With An Arena Allocator") {
+  GIVEN("Trees sharing one arena") {
+    forest::arena_allocator <std::pair <const int, std::string> > allocator(std::make_shared <forest::arena>());
+    forest::rbtree <int, std::string, std::less <int>, forest::arena_allocator <std::pair <const int, std::string> > > rbtree(allocator);
+    forest::avltree <int, std::string, std::less <int>, forest::arena_allocator <std::pair <const int, std::string> > > avltree(allocator);
+    forest::splaytree <int, std::string, std::less <int>, forest::arena_allocator <std::pair <const int, std::string> > > splaytree(allocator);
+    WHEN("Nodes are inserted and erased") {
+      for (int i = 0; i < 1000; i++) {
+        rbtree.insert(i, std::to_string(i));
+        avltree.insert(i, std::to_string(i));
+        splaytree.insert(i, std::to_string(i));
+      }
+      for (int i = 0; i < 1000; i += 2) {
+        rbtree.erase(i);
+        avltree.erase(i);
+        splaytree.erase(i);
+      }
+      THEN("Test contents") {
+        REQUIRE(rbtree.size() == 500);
+        REQUIRE(avltree.size() == 500);
+        REQUIRE(splaytree.size() == 500);
+        REQUIRE(rbtree.search(501)->value == "501");
+        REQUIRE(avltree.search(501)->value == "501");
+        REQUIRE(splaytree.search(501)->value == "501");
+      }
+      THEN("Test allocator") {
+        REQUIRE(rbtree.get_allocator() == allocator);
+        REQUIRE(avltree.get_allocator() == allocator);
+        REQUIRE(splaytree.get_allocator() == allocator);
+      }
+      THEN("Test clear") {
+        rbtree.clear();
+        avltree.clear();
+        splaytree.clear();
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(avltree.empty() == true);
+        REQUIRE(splaytree.empty() == true);
+      }
+    }
+  }
+  GIVEN("A tree with trivially destructible keys and values") {
+    forest::rbtree <int, int, std::less <int>, forest::arena_allocator <std::pair <const int, int> > > rbtree;
+    WHEN("Nodes are inserted") {
+      for (int i = 0; i < 100000; i++) {
+        rbtree.insert(i, i);
+      }
+      THEN("Test size") {
+        REQUIRE(rbtree.size() == 100000);
+      }
+    }
+  }
+}
\ No newline at end of file
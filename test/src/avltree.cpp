@@ -5,9 +5,84 @@
 
 #include <catch2/catch.hpp>
 #include <forest/avltree.hpp>
+#include <forest/thread_pool.hpp>
+#include <forest/rbtree.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
-auto handler = [](const int & key, const int & value) {};
+namespace {
+  class less_only {
+  public:
+    explicit less_only(int VALUE) : value(VALUE) {
+
+    }
+    bool operator<(const less_only & other) const {
+      return value < other.value;
+    }
+    int value;
+  };
+
+  class counting_less {
+  public:
+    explicit counting_less(size_t * COUNT) : count(COUNT) {
+
+    }
+    bool operator()(int lhs, int rhs) const {
+      (*count)++;
+      return lhs < rhs;
+    }
+    size_t * count;
+  };
+
+  int copies {0};
+
+  class copy_counter {
+  public:
+    copy_counter() = default;
+    copy_counter(const copy_counter &) {
+      copies++;
+    }
+    copy_counter(copy_counter &&) = default;
+    copy_counter& operator=(const copy_counter &) {
+      copies++;
+      return *this;
+    }
+    copy_counter& operator=(copy_counter &&) = default;
+  };
+
+  int live_nodes {0};
+
+  template <typename V>
+  class counting_allocator : public std::allocator <V> {
+  public:
+    template <typename W>
+    struct rebind {
+      using other = counting_allocator <W>;
+    };
+    counting_allocator() = default;
+    template <typename W>
+    counting_allocator(const counting_allocator <W> &) noexcept {
+
+    }
+    V * allocate(size_t n) {
+      live_nodes += static_cast<int>(n);
+      return std::allocator <V>::allocate(n);
+    }
+    void deallocate(V * storage, size_t n) {
+      live_nodes -= static_cast<int>(n);
+      std::allocator <V>::deallocate(storage, n);
+    }
+  };
+}
+
+static auto handler = [](const int & key, const int & value) {};
 
 TEST_CASE("Test AVL Tree Constructor") {
   forest::avltree <int, std::string> avltree({
@@ -28,6 +103,518 @@ TEST_CASE("Test AVL Tree Constructor") {
   REQUIRE(avltree.search(45)->value == "Heimdall");
 }
 
+TEST_CASE("Test AVL Tree Allocator") {
+  {
+    forest::avltree <int, std::string, std::less <int>, counting_allocator <std::pair <const int, std::string> > > avltree;
+    for (int i = 0; i < 100; i++) {
+      avltree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 0; i < 50; i++) {
+      avltree.erase(i);
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 100; i < 150; i++) {
+      avltree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+  }
+  REQUIRE(live_nodes == 0);
+}
+
+TEST_CASE("Test AVL Tree Comparator") {
+  SECTION("Test a reversed order") {
+    forest::avltree <int, int, std::greater <int> > avltree({{1, 1}, {2, 2}, {3, 3}, {4, 4}});
+    std::vector <int> keys;
+    for (auto & node : avltree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {4, 3, 2, 1});
+    REQUIRE(avltree.minimum()->key == 4);
+    REQUIRE(avltree.search(3)->value == 3);
+    REQUIRE(avltree.rank(2) == 2);
+  }
+  SECTION("Test keys that only define operator<") {
+    forest::avltree <less_only, int> avltree;
+    avltree.insert(less_only(2), 2);
+    avltree.insert(less_only(1), 1);
+    avltree.insert(less_only(2), 3);
+    REQUIRE(avltree.size() == 2);
+    REQUIRE(avltree.search(less_only(2))->value == 3);
+    REQUIRE(avltree.search(less_only(5)) == nullptr);
+    REQUIRE(avltree.erase(less_only(1)) == 1);
+  }
+  SECTION("Test one comparison per level") {
+    size_t count {0};
+    forest::avltree <int, int, counting_less> avltree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      avltree.insert((i * 7919) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i++) {
+      count = 0;
+      REQUIRE(avltree.search(i) != nullptr);
+      REQUIRE(count <= avltree.height() + 1);
+    }
+  }
+}
+
+TEST_CASE("Test AVL Tree Move Semantics") {
+  SECTION("Test move-only values") {
+    forest::avltree <int, std::unique_ptr <int> > avltree;
+    REQUIRE(avltree.insert(1, std::unique_ptr <int>(new int(1))).second == true);
+    REQUIRE(avltree.insert(1, std::unique_ptr <int>(new int(2))).second == false);
+    REQUIRE(*avltree.search(1)->value == 2);
+    REQUIRE(avltree.try_emplace(2, new int(3)).second == true);
+    REQUIRE(*avltree.search(2)->value == 3);
+  }
+  SECTION("Test try_emplace leaves its arguments alone when the key exists") {
+    forest::avltree <int, std::unique_ptr <int> > avltree;
+    avltree.try_emplace(1, new int(1));
+    std::unique_ptr <int> value(new int(2));
+    auto result = avltree.try_emplace(1, std::move(value));
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->key == 1);
+    REQUIRE(value != nullptr);
+    REQUIRE(*avltree.search(1)->value == 1);
+  }
+  SECTION("Test insert_or_assign") {
+    forest::avltree <int, std::string> avltree;
+    REQUIRE(avltree.insert_or_assign(1, "Thor").second == true);
+    auto result = avltree.insert_or_assign(1, "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "Odin");
+    REQUIRE(avltree.size() == 1);
+  }
+  SECTION("Test emplace") {
+    forest::avltree <std::string, std::string> avltree;
+    REQUIRE(avltree.emplace("Thor", 3, 'a').second == true);
+    REQUIRE(avltree.search("Thor")->value == "aaa");
+    auto result = avltree.emplace("Thor", "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "aaa");
+    REQUIRE(avltree.size() == 1);
+  }
+  SECTION("Test move construction") {
+    forest::avltree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    auto root = source.root();
+    forest::avltree <int, int> avltree(std::move(source));
+    REQUIRE(avltree.root() == root);
+    REQUIRE(avltree.size() == 3);
+    REQUIRE(source.empty() == true);
+    source.insert(4, 4);
+    REQUIRE(source.size() == 1);
+  }
+  SECTION("Test move assignment") {
+    forest::avltree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    forest::avltree <int, int> avltree({{4, 4}});
+    avltree = std::move(source);
+    REQUIRE(avltree.size() == 3);
+    REQUIRE(avltree.search(4) == nullptr);
+    REQUIRE(avltree.search(2)->value == 2);
+    REQUIRE(source.empty() == true);
+  }
+  SECTION("Test swap") {
+    forest::avltree <int, int> first({{1, 1}, {2, 2}, {3, 3}});
+    forest::avltree <int, int> second({{4, 4}});
+    swap(first, second);
+    REQUIRE(first.size() == 1);
+    REQUIRE(first.search(4) != nullptr);
+    REQUIRE(second.size() == 3);
+    REQUIRE(second.search(1) != nullptr);
+  }
+  SECTION("Test trees in a vector") {
+    std::vector <forest::avltree <int, int> > trees;
+    for (int i = 0; i < 10; i++) {
+      trees.emplace_back();
+      trees.back().insert(i, i);
+    }
+    for (int i = 0; i < 10; i++) {
+      REQUIRE(trees[i].search(i) != nullptr);
+      REQUIRE(trees[i].size() == 1);
+    }
+  }
+  SECTION("Test rvalues are not copied") {
+    forest::avltree <int, copy_counter> avltree;
+    copies = 0;
+    for (int i = 0; i < 10; i++) {
+      avltree.insert(i, copy_counter());
+      avltree.insert_or_assign(i, copy_counter());
+      avltree.try_emplace(i + 10);
+    }
+    REQUIRE(copies == 0);
+    REQUIRE(avltree.size() == 20);
+  }
+}
+
+TEST_CASE("Test AVL Tree Bulk Construction") {
+  SECTION("Test a sorted range") {
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 1000; i++) {
+      elements.emplace_back(i, i * 2);
+    }
+    forest::avltree <int, int> avltree(elements.begin(), elements.end());
+    REQUIRE(avltree.size() == 1000);
+    REQUIRE(avltree.height() == 10);
+    REQUIRE(avltree.root()->key == 500);
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(avltree.search(i)->value == i * 2);
+      REQUIRE(avltree.select(i)->key == i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(avltree.erase(i) == 1);
+    }
+    for (int i = 1000; i < 1100; i++) {
+      avltree.insert(i, i);
+    }
+    REQUIRE(avltree.size() == 600);
+    REQUIRE(avltree.rank(1000) == 500);
+  }
+  SECTION("Test an unsorted range with duplicate keys") {
+    std::vector <std::pair <int, std::string> > elements {{3, "Baldr"}, {1, "Thor"}, {3, "Frigg"}, {2, "Odin"}, {1, "Loki"}};
+    forest::avltree <int, std::string> avltree(elements.begin(), elements.end());
+    REQUIRE(avltree.size() == 3);
+    REQUIRE(avltree.search(1)->value == "Loki");
+    REQUIRE(avltree.search(2)->value == "Odin");
+    REQUIRE(avltree.search(3)->value == "Frigg");
+  }
+  SECTION("Test a parallel build from an unsorted range") {
+    forest::thread_pool pool(2);
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 50000; i++) {
+      elements.emplace_back((i * 7919) % 40000, i);
+    }
+    forest::avltree <int, int> avltree(elements.begin(), elements.end(), pool);
+    REQUIRE(avltree.size() == 40000);
+    for (int i = 0; i < 40000; i++) {
+      REQUIRE(avltree.select(i)->key == i);
+    }
+    for (int i = 10000; i < 50000; i++) {
+      REQUIRE(avltree.search((i * 7919) % 40000)->value == i);
+    }
+    avltree.assign(elements.begin(), elements.begin() + 100, pool);
+    REQUIRE(avltree.size() == 100);
+    REQUIRE(avltree.search(0)->value == 0);
+  }
+  SECTION("Test assign replaces the contents") {
+    forest::avltree <int, int> avltree({{1, 1}, {2, 2}, {3, 3}});
+    std::vector <std::pair <int, int> > elements {{4, 4}, {5, 5}};
+    avltree.assign(elements.begin(), elements.end());
+    REQUIRE(avltree.size() == 2);
+    REQUIRE(avltree.search(1) == nullptr);
+    REQUIRE(avltree.minimum()->key == 4);
+    avltree.assign(elements.end(), elements.end());
+    REQUIRE(avltree.empty() == true);
+  }
+  SECTION("Test converting from another tree") {
+    forest::rbtree <int, std::string> source({{2, "Thor"}, {4, "Odin"}, {90, "Loki"}, {3, "Baldr"}});
+    forest::avltree <int, std::string> avltree(source.begin(), source.end());
+    REQUIRE(avltree.size() == 4);
+    REQUIRE(avltree.search(90)->value == "Loki");
+    REQUIRE(avltree.minimum()->key == 2);
+    REQUIRE(avltree.maximum()->key == 90);
+  }
+}
+
+TEST_CASE("Test AVL Tree Parallel Traversal") {
+  forest::thread_pool pool(2);
+  forest::avltree <int, int> avltree;
+  REQUIRE(avltree.parallel_reduce(0L, [](const int & key, const int &) {
+    return static_cast<long>(key);
+  }, std::plus <long>(), pool) == 0);
+  for (int i = 0; i < 20000; i++) {
+    avltree.insert((i * 7919) % 20000, i % 10);
+  }
+  SECTION("Test parallel_for_each visits every node") {
+    std::atomic <long> sum {0};
+    avltree.parallel_for_each([&](const int & key, const int &) {
+      sum += key;
+    }, pool);
+    REQUIRE(sum == 199990000L);
+  }
+  SECTION("Test parallel_reduce combines in key order") {
+    std::string expected;
+    avltree.in_order_traversal([&](const int &, const int & value) {
+      expected += std::to_string(value);
+    });
+    std::string digits {avltree.parallel_reduce(std::string(), [](const int &, const int & value) {
+      return std::to_string(value);
+    }, [](std::string lhs, const std::string & rhs) {
+      return lhs += rhs;
+    }, pool)};
+    REQUIRE(digits == expected);
+  }
+}
+
+TEST_CASE("Test AVL Tree Split And Join") {
+  forest::avltree <int, int> avltree;
+  for (int i = 0; i < 1000; i++) {
+    avltree.insert(i, i);
+  }
+  SECTION("Test split") {
+    auto parts = avltree.split(300);
+    REQUIRE(avltree.empty() == true);
+    REQUIRE(parts.first.size() == 300);
+    REQUIRE(parts.second.size() == 700);
+    REQUIRE(parts.first.maximum()->key == 299);
+    REQUIRE(parts.second.minimum()->key == 300);
+    REQUIRE(parts.first.height() <= 2 * std::log2(parts.first.size() + 1));
+    REQUIRE(parts.second.height() <= 2 * std::log2(parts.second.size() + 1));
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE((i < 300 ? parts.first : parts.second).search(i)->value == i);
+    }
+    REQUIRE(parts.first.rank(150) == 150);
+    REQUIRE(parts.second.select(0)->key == 300);
+    parts.first.insert(1000, 1000);
+    REQUIRE(parts.first.maximum()->key == 1000);
+  }
+  SECTION("Test split at the ends") {
+    auto low = avltree.split(-1);
+    REQUIRE(low.first.empty() == true);
+    REQUIRE(low.second.size() == 1000);
+    auto high = low.second.split(1000);
+    REQUIRE(high.first.size() == 1000);
+    REQUIRE(high.second.empty() == true);
+  }
+  SECTION("Test join") {
+    auto parts = avltree.split(500);
+    parts.second.erase(500);
+    auto joined = forest::avltree <int, int>::join(std::move(parts.first), 500, -1, std::move(parts.second));
+    REQUIRE(joined.size() == 1000);
+    REQUIRE(joined.search(500)->value == -1);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    int expected {0};
+    for (auto & node : joined) {
+      REQUIRE(node.key == expected++);
+    }
+  }
+  SECTION("Test join of trees with different heights") {
+    forest::avltree <int, int> small({{2000, 2000}});
+    auto joined = forest::avltree <int, int>::join(std::move(avltree), 1500, 1500, std::move(small));
+    REQUIRE(joined.size() == 1002);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    REQUIRE(joined.rank(1500) == 1000);
+    REQUIRE(joined.maximum()->key == 2000);
+  }
+  SECTION("Test concat") {
+    auto parts = avltree.split(10);
+    auto joined = forest::avltree <int, int>::concat(std::move(parts.second), forest::avltree <int, int>());
+    joined = forest::avltree <int, int>::concat(std::move(parts.first), std::move(joined));
+    REQUIRE(joined.size() == 1000);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(joined.select(i)->key == i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(joined.erase(i) == 1);
+    }
+    REQUIRE(joined.size() == 500);
+  }
+}
+
+TEST_CASE("Test AVL Tree Set Operations") {
+  forest::thread_pool pool(2);
+  std::mt19937 generator(11);
+  std::uniform_int_distribution <int> distribution(0, 39999);
+  forest::avltree <int, int> first;
+  forest::avltree <int, int> second;
+  std::map <int, int> first_map;
+  std::map <int, int> second_map;
+  for (int i = 0; i < 20000; i++) {
+    int key {distribution(generator)};
+    first.insert(key, 1);
+    first_map[key] = 1;
+    key = distribution(generator);
+    second.insert(key, 2);
+    second_map[key] = 2;
+  }
+  auto require_equal = [](forest::avltree <int, int> & avltree, const std::map <int, int> & map) {
+    REQUIRE(avltree.size() == map.size());
+    REQUIRE(avltree.height() <= 2 * std::log2(avltree.size() + 1));
+    auto it = map.begin();
+    for (auto & node : avltree) {
+      REQUIRE(node.key == it->first);
+      REQUIRE(node.value == it->second);
+      ++it;
+    }
+  };
+  SECTION("Test union_with") {
+    std::map <int, int> expected {first_map};
+    for (const auto & element : second_map) {
+      expected[element.first] = element.second;
+    }
+    first.union_with(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test intersect_with") {
+    std::map <int, int> expected;
+    for (const auto & element : first_map) {
+      if (second_map.count(element.first)) expected.insert(element);
+    }
+    first.intersect_with(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test difference") {
+    std::map <int, int> expected;
+    for (const auto & element : first_map) {
+      if (!second_map.count(element.first)) expected.insert(element);
+    }
+    first.difference(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test without a thread pool") {
+    std::map <int, int> expected {second_map};
+    for (const auto & element : first_map) {
+      expected[element.first] = element.second;
+    }
+    second.union_with(std::move(first));
+    require_equal(second, expected);
+    second.difference(forest::avltree <int, int>({{0, 0}, {1, 0}}));
+    expected.erase(0);
+    expected.erase(1);
+    require_equal(second, expected);
+    second.intersect_with(forest::avltree <int, int>());
+    REQUIRE(second.empty() == true);
+  }
+}
+
+TEST_CASE("Test AVL Tree Bounds") {
+  forest::avltree <int, int> avltree;
+  std::map <int, int> map;
+  for (int i = 0; i < 200; i += 3) {
+    avltree.insert(i, i);
+    map[i] = i;
+  }
+  SECTION("Test lower_bound, upper_bound and equal_range") {
+    for (int i = -5; i < 210; i++) {
+      auto lower = avltree.lower_bound(i);
+      auto upper = avltree.upper_bound(i);
+      auto range = avltree.equal_range(i);
+      REQUIRE((lower == avltree.end()) == (map.lower_bound(i) == map.end()));
+      REQUIRE((upper == avltree.end()) == (map.upper_bound(i) == map.end()));
+      if (lower != avltree.end()) REQUIRE(lower->key == map.lower_bound(i)->first);
+      if (upper != avltree.end()) REQUIRE(upper->key == map.upper_bound(i)->first);
+      REQUIRE(range.first == lower);
+      REQUIRE(range.second == upper);
+      REQUIRE(std::distance(range.first, range.second) == static_cast<std::ptrdiff_t>(map.count(i)));
+    }
+  }
+  SECTION("Test floor and ceiling") {
+    REQUIRE(avltree.floor(-1) == nullptr);
+    REQUIRE(avltree.floor(0)->key == 0);
+    REQUIRE(avltree.floor(5)->key == 3);
+    REQUIRE(avltree.floor(1000)->key == 198);
+    REQUIRE(avltree.ceiling(-1)->key == 0);
+    REQUIRE(avltree.ceiling(4)->key == 6);
+    REQUIRE(avltree.ceiling(6)->key == 6);
+    REQUIRE(avltree.ceiling(199) == nullptr);
+  }
+  SECTION("Test for_each_in_range") {
+    std::vector <int> keys;
+    avltree.for_each_in_range(10, 22, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys == std::vector <int> {12, 15, 18, 21});
+    keys.clear();
+    avltree.for_each_in_range(12, 12, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys.empty() == true);
+    avltree.for_each_in_range(0, 1000, [&](const int & key, const int & value) {
+      keys.push_back(key);
+      return keys.size() < 3;
+    });
+    REQUIRE(keys == std::vector <int> {0, 3, 6});
+  }
+}
+
+TEST_CASE("Test AVL Tree Hinted Insert") {
+  SECTION("Test appends cost one comparison") {
+    size_t count {0};
+    forest::avltree <int, int, counting_less> avltree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      avltree.insert(i, i);
+    }
+    REQUIRE(count < 1000);
+    REQUIRE(avltree.size() == 1000);
+    REQUIRE(avltree.maximum()->key == 999);
+    REQUIRE(avltree.erase(999) == 1);
+    REQUIRE(avltree.maximum()->key == 998);
+    avltree.insert(500, 0);
+    REQUIRE(avltree.maximum()->key == 998);
+    REQUIRE(avltree.search(500)->value == 0);
+  }
+  SECTION("Test a correct hint") {
+    size_t count {0};
+    forest::avltree <int, int, counting_less> avltree((counting_less(&count)));
+    for (int i = 0; i < 1000; i += 2) {
+      avltree.insert(i, i);
+    }
+    for (int i = 1; i < 1000; i += 2) {
+      auto hint = avltree.search(i + 1);
+      count = 0;
+      auto result = avltree.insert(hint, i, i);
+      REQUIRE(count <= 3);
+      REQUIRE(result->key == i);
+    }
+    REQUIRE(avltree.size() == 1000);
+    int expected {0};
+    for (auto & node : avltree) {
+      REQUIRE(node.key == expected++);
+    }
+  }
+  SECTION("Test a wrong hint") {
+    forest::avltree <int, int> avltree({{1, 1}, {5, 5}, {9, 9}});
+    REQUIRE(avltree.insert(avltree.begin(), 7, 7)->key == 7);
+    REQUIRE(avltree.insert(avltree.end(), 3, 3)->key == 3);
+    REQUIRE(avltree.insert(avltree.end(), 10, 10)->key == 10);
+    REQUIRE(avltree.insert(avltree.search(9), 9, 0)->value == 0);
+    REQUIRE(avltree.size() == 6);
+    std::vector <int> keys;
+    for (auto & node : avltree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {1, 3, 5, 7, 9, 10});
+    REQUIRE((--avltree.end())->key == 10);
+  }
+}
+
+TEST_CASE("Test AVL Tree Batch Insert") {
+  std::mt19937 generator(7);
+  std::uniform_int_distribution <int> distribution(0, 99999);
+  forest::avltree <int, int> avltree;
+  std::map <int, int> map;
+  auto insert_batch = [&](size_t count) {
+    std::vector <std::pair <int, int> > batch;
+    for (size_t i = 0; i < count; i++) {
+      batch.emplace_back(distribution(generator), distribution(generator));
+      map[batch.back().first] = batch.back().second;
+    }
+    avltree.insert_batch(batch.begin(), batch.end());
+    REQUIRE(avltree.size() == map.size());
+    REQUIRE(avltree.height() <= 2 * std::log2(avltree.size() + 1));
+    for (const auto & element : map) {
+      REQUIRE(avltree.search(element.first)->value == element.second);
+    }
+  };
+  SECTION("Test a batch larger than the tree") {
+    insert_batch(1000);
+    insert_batch(5000);
+  }
+  SECTION("Test a batch smaller than the tree") {
+    insert_batch(5000);
+    insert_batch(100);
+    insert_batch(1000);
+  }
+  SECTION("Test an empty batch") {
+    insert_batch(0);
+    insert_batch(100);
+    insert_batch(0);
+  }
+}
+
 SCENARIO("Test AVL Tree") {
   GIVEN("An AVL Tree") {
     forest::avltree <int, int> avltree;
@@ -73,6 +660,26 @@ SCENARIO("Test AVL Tree") {
       THEN("Call post_order_traversal") {
         avltree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(avltree.rank(42) == 0);
+      }
+      THEN("Test select") {
+        REQUIRE(avltree.select(0) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(avltree.count_range(0, 100) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(avltree.percentile(50) == nullptr);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        REQUIRE(avltree.sample(generator) == nullptr);
+      }
+      THEN("Test iterators") {
+        REQUIRE(avltree.begin() == avltree.end());
+        REQUIRE(avltree.rbegin() == avltree.rend());
+      }
     }
     WHEN("Nodes are inserted in random order") {
       avltree.insert(4 , 0);
@@ -142,6 +749,125 @@ SCENARIO("Test AVL Tree") {
       THEN("Call post_order_traversal") {
         avltree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(avltree.rank(0) == 0);
+        REQUIRE(avltree.rank(3) == 2);
+        REQUIRE(avltree.rank(5) == 4);
+        REQUIRE(avltree.rank(1337) == 7);
+      }
+      THEN("Test select") {
+        REQUIRE(avltree.select(0)->key == 0);
+        REQUIRE(avltree.select(3)->key == 4);
+        REQUIRE(avltree.select(6)->key == 90);
+        REQUIRE(avltree.select(7) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(avltree.count_range(2, 14) == 3);
+        REQUIRE(avltree.count_range(1, 100) == 6);
+        REQUIRE(avltree.count_range(14, 2) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(avltree.percentile(0)->key == 0);
+        REQUIRE(avltree.percentile(50)->key == 4);
+        REQUIRE(avltree.percentile(99)->key == 90);
+        REQUIRE(avltree.percentile(100)->key == 90);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        for (int i = 0; i < 100; i++) {
+          auto result = avltree.sample(generator);
+          REQUIRE(result != nullptr);
+          REQUIRE(avltree.search(result->key) == result);
+        }
+      }
+      THEN("Test erase for a node that does not exist") {
+        REQUIRE(avltree.erase(1337) == 0);
+        REQUIRE(avltree.size() == 7);
+      }
+      THEN("Test erase for a node that does exist") {
+        REQUIRE(avltree.erase(4) == 1);
+        REQUIRE(avltree.search(4) == nullptr);
+        REQUIRE(avltree.size() == 6);
+        REQUIRE(avltree.select(2)->key == 3);
+        REQUIRE(avltree.select(3)->key == 14);
+        REQUIRE(avltree.erase(0) == 1);
+        REQUIRE(avltree.erase(90) == 1);
+        REQUIRE(avltree.minimum()->key == 2);
+        REQUIRE(avltree.maximum()->key == 45);
+        REQUIRE(avltree.size() == 4);
+      }
+      THEN("Test erase recycles nodes") {
+        auto node = avltree.search(14);
+        avltree.erase(14);
+        avltree.insert(15, 0);
+        REQUIRE(avltree.search(15) == node);
+      }
+      THEN("Test iterators") {
+        std::vector <int> keys;
+        for (auto & node : avltree) {
+          keys.push_back(node.key);
+        }
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        REQUIRE(std::distance(avltree.begin(), avltree.end()) == 7);
+        REQUIRE((--avltree.end())->key == 90);
+        REQUIRE(std::prev(avltree.end(), 7) == avltree.begin());
+      }
+      THEN("Test reverse iterators") {
+        std::vector <int> keys;
+        for (auto it = avltree.rbegin(); it != avltree.rend(); ++it) {
+          keys.push_back(it->key);
+        }
+        REQUIRE(keys == std::vector <int> {90, 45, 14, 4, 3, 2, 0});
+      }
+      THEN("Test iterators with algorithms") {
+        auto it = std::find_if(avltree.begin(), avltree.end(), [](const auto & node) { return node.key > 10; });
+        REQUIRE(it != avltree.end());
+        REQUIRE(it->key == 14);
+        REQUIRE(std::count_if(avltree.begin(), avltree.end(), [](const auto & node) { return node.key % 2 == 0; }) == 5);
+      }
+      THEN("Call traversals with a capturing handler") {
+        std::vector <int> keys;
+        avltree.in_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        keys.clear();
+        avltree.pre_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == avltree.root()->key);
+        keys.clear();
+        avltree.post_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.back() == avltree.root()->key);
+        keys.clear();
+        avltree.breadth_first_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == avltree.root()->key);
+      }
+      THEN("Call traversals with a handler that stops early") {
+        std::vector <int> keys;
+        auto handler = [&keys](const int & key, const int & value) {
+          keys.push_back(key);
+          return keys.size() < 3;
+        };
+        avltree.in_order_traversal(handler);
+        REQUIRE(keys == std::vector <int> {0, 2, 3});
+        keys.clear();
+        avltree.pre_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        avltree.post_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        avltree.breadth_first_traversal(handler);
+        REQUIRE(keys.size() == 3);
+      }
+      THEN("Test clear") {
+        avltree.clear();
+        REQUIRE(avltree.empty() == true);
+        REQUIRE(avltree.size() == 0);
+        REQUIRE(avltree.root() == nullptr);
+        avltree.insert(1, 1);
+        REQUIRE(avltree.size() == 1);
+      }
     }
     WHEN("Nodes are inserted in ascending order") {
       for (int i = 0; i < 10; i++) {
@@ -207,6 +933,12 @@ SCENARIO("Test AVL Tree") {
       THEN("Call post_order_traversal") {
         avltree.post_order_traversal(handler);
       }
+      THEN("Test rank and select") {
+        for (int i = 0; i < 10; i++) {
+          REQUIRE(avltree.rank(i) == static_cast<size_t>(i));
+          REQUIRE(avltree.select(i)->key == i);
+        }
+      }
     }
     WHEN("Nodes are inserted in descending order") {
       for (int i = 9; i >= 0; i--) {
@@ -273,5 +1005,70 @@ SCENARIO("Test AVL Tree") {
         avltree.post_order_traversal(handler);
       }
     }
+    WHEN("A large number of nodes are inserted in descending order") {
+      const int n {1 << 20};
+      size_t count {0};
+      size_t most {0};
+      forest::avltree <int, int, counting_less> counted((counting_less(&count)));
+      for (int i = n - 1; i >= 0; i--) {
+        count = 0;
+        counted.insert(i, i);
+        most = std::max(most, count);
+      }
+      THEN("Test every insert costs O(log n) comparisons") {
+        REQUIRE(most <= 1.44 * std::log2(n + 2) + 2);
+      }
+      THEN("Test size") {
+        REQUIRE(counted.size() == n);
+      }
+      THEN("Test height") {
+        REQUIRE(counted.height() <= 1.44 * std::log2(n + 2));
+      }
+      THEN("Test minimum and maximum") {
+        REQUIRE(counted.minimum()->key == 0);
+        REQUIRE(counted.maximum()->key == n - 1);
+      }
+    }
+    WHEN("Nodes are inserted and erased in random order") {
+      std::map <int, int> map;
+      std::mt19937 generator;
+      std::uniform_int_distribution <int> distribution(0, 999);
+      for (int i = 0; i < 20000; i++) {
+        int key {distribution(generator)};
+        if (i % 3 == 0) {
+          REQUIRE(avltree.erase(key) == map.erase(key));
+        } else {
+          avltree.insert(key, i);
+          map[key] = i;
+        }
+      }
+      THEN("Test size") {
+        REQUIRE(avltree.size() == map.size());
+      }
+      THEN("Test height") {
+        REQUIRE(avltree.height() <= 1.44 * std::log2(avltree.size() + 2));
+        REQUIRE(avltree.height() <= avltree.size());
+      }
+      THEN("Test contents") {
+        size_t index {0};
+        for (auto element : map) {
+          auto node = avltree.select(index++);
+          REQUIRE(node->key == element.first);
+          REQUIRE(node->value == element.second);
+        }
+      }
+      THEN("Test erase until empty") {
+        for (auto element : map) {
+          REQUIRE(avltree.erase(element.first) == 1);
+        }
+        REQUIRE(avltree.empty() == true);
+        REQUIRE(avltree.size() == 0);
+      }
+      THEN("Test iterators") {
+        REQUIRE(std::equal(avltree.begin(), avltree.end(), map.begin(), map.end(), [](const auto & node, const auto & element) {
+          return node.key == element.first && node.value == element.second;
+        }));
+      }
+    }
   }
 }
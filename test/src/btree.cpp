@@ -0,0 +1,148 @@
+/*
+ * @file btree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/btree.hpp>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <typename Tree>
+  bool matches(Tree & tree, const std::map <int, std::string> & map) {
+    if (tree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    tree.in_order_traversal([&](const int & key, const std::string & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+TEST_CASE("Test B Tree Fanout") {
+  forest::btree <int, std::string, std::less <int>, std::allocator <std::pair <const int, std::string> >, 4> btree;
+  std::map <int, std::string> map;
+  std::mt19937 generator;
+  for (int i = 0; i < 20000; i++) {
+    int key {static_cast<int>(generator() % 2000)};
+    if (generator() % 3) {
+      auto result = btree.insert(key, std::to_string(i));
+      REQUIRE(result.second == (map.count(key) == 0));
+      REQUIRE(result.first->key == key);
+      map[key] = std::to_string(i);
+    } else {
+      REQUIRE(btree.erase(key) == map.erase(key));
+    }
+  }
+  REQUIRE(matches(btree, map));
+  REQUIRE(btree.height() <= 11);
+}
+
+TEST_CASE("Test B Tree Move Semantics") {
+  forest::btree <int, std::string> btree({{1, "Thor"}, {2, "Odin"}, {3, "Loki"}});
+  forest::btree <int, std::string> moved(std::move(btree));
+  REQUIRE(btree.empty() == true);
+  REQUIRE(moved.size() == 3);
+  btree = std::move(moved);
+  REQUIRE(moved.empty() == true);
+  REQUIRE(btree.search(2)->value == "Odin");
+  swap(btree, moved);
+  REQUIRE(moved.size() == 3);
+  REQUIRE(btree.search(2) == nullptr);
+}
+
+SCENARIO("Test B Tree") {
+  GIVEN("A B Tree") {
+    forest::btree <int, std::string> btree;
+    WHEN("The B Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(btree.empty() == true);
+        REQUIRE(btree.size() == 0);
+        REQUIRE(btree.height() == 0);
+        REQUIRE(btree.minimum() == nullptr);
+        REQUIRE(btree.maximum() == nullptr);
+        REQUIRE(btree.search(555) == nullptr);
+        REQUIRE(btree.erase(555) == 0);
+      }
+    }
+    WHEN("Nodes are inserted in random order") {
+      std::vector <int> keys;
+      for (int i = 0; i < 100000; i++) {
+        keys.push_back(i);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937());
+      std::map <int, std::string> map;
+      for (int key : keys) {
+        btree.insert(key, std::to_string(key));
+        map[key] = std::to_string(key);
+      }
+      THEN("Test the B Tree matches a map") {
+        REQUIRE(matches(btree, map));
+        REQUIRE(btree.height() <= 4);
+        REQUIRE(btree.minimum()->key == 0);
+        REQUIRE(btree.maximum()->key == 99999);
+      }
+      THEN("Test insert overwrites a value") {
+        auto result = btree.insert(42, "Frigg");
+        REQUIRE(result.second == false);
+        REQUIRE(btree.search(42)->value == "Frigg");
+        REQUIRE(btree.size() == 100000);
+      }
+      THEN("Test breadth_first_traversal visits every node") {
+        size_t count {0};
+        btree.breadth_first_traversal([&](const int &, const std::string &) {
+          count++;
+        });
+        REQUIRE(count == 100000);
+      }
+      THEN("Test pre_order_traversal and post_order_traversal visit every node") {
+        int first {-1};
+        btree.breadth_first_traversal([&](const int & key, const std::string &) {
+          first = key;
+          return false;
+        });
+        std::vector <int> pre_order;
+        btree.pre_order_traversal([&](const int & key, const std::string &) {
+          pre_order.push_back(key);
+        });
+        std::vector <int> post_order;
+        btree.post_order_traversal([&](const int & key, const std::string &) {
+          post_order.push_back(key);
+        });
+        REQUIRE(pre_order.size() == 100000);
+        REQUIRE(post_order.size() == 100000);
+        REQUIRE(pre_order.front() == first);
+        REQUIRE(post_order.front() == 0);
+        std::sort(pre_order.begin(), pre_order.end());
+        std::sort(post_order.begin(), post_order.end());
+        REQUIRE(pre_order == post_order);
+        REQUIRE(std::adjacent_find(pre_order.begin(), pre_order.end()) == pre_order.end());
+        size_t count {0};
+        btree.post_order_traversal([&](const int &, const std::string &) {
+          return ++count < 10;
+        });
+        REQUIRE(count == 10);
+      }
+      THEN("Test erase until empty") {
+        for (int key : keys) {
+          REQUIRE(btree.erase(key) == 1);
+          map.erase(key);
+          if (key % 1000 == 0) {
+            REQUIRE(matches(btree, map));
+          }
+        }
+        REQUIRE(btree.empty() == true);
+        REQUIRE(btree.height() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ * @file compact_avltree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/compact_avltree.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <typename Tree>
+  bool matches(Tree & tree, const std::map <int, std::string> & map) {
+    if (tree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    tree.in_order_traversal([&](const int & key, const std::string & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+TEST_CASE("Test Compact AVL Tree Random Operations") {
+  forest::compact_avltree <int, std::string> avltree;
+  std::map <int, std::string> map;
+  std::mt19937 generator;
+  for (int i = 0; i < 20000; i++) {
+    int key {static_cast<int>(generator() % 2000)};
+    if (generator() % 3) {
+      auto result = avltree.insert(key, std::to_string(i));
+      REQUIRE(result.second == (map.count(key) == 0));
+      REQUIRE(result.first->key == key);
+      map[key] = std::to_string(i);
+    } else {
+      REQUIRE(avltree.erase(key) == map.erase(key));
+    }
+  }
+  REQUIRE(matches(avltree, map));
+  REQUIRE(avltree.height() <= 15);
+}
+
+TEST_CASE("Test Compact AVL Tree Handles Survive Growth") {
+  forest::compact_avltree <int, std::string> avltree;
+  auto handle = avltree.insert(-1, "Thor").first;
+  avltree.insert(-2, "Odin");
+  for (int i = 0; i < 1000; i++) {
+    avltree.insert(i, std::string(32, 'a'));
+  }
+  REQUIRE(avltree.erase(-2) == 1);
+  REQUIRE(handle->value == "Thor");
+  REQUIRE(avltree.search(-1) == handle);
+  avltree.reserve(4096);
+  REQUIRE(handle->value == "Thor");
+  avltree.insert(2000, avltree.search(-1)->value);
+  REQUIRE(avltree.search(2000)->value == "Thor");
+}
+
+TEST_CASE("Test Compact AVL Tree Move Semantics") {
+  forest::compact_avltree <int, std::string> avltree({{1, "Thor"}, {2, "Odin"}, {3, "Loki"}});
+  forest::compact_avltree <int, std::string> moved(std::move(avltree));
+  REQUIRE(avltree.empty() == true);
+  REQUIRE(moved.size() == 3);
+  avltree = std::move(moved);
+  REQUIRE(moved.empty() == true);
+  REQUIRE(avltree.search(2)->value == "Odin");
+  swap(avltree, moved);
+  REQUIRE(moved.size() == 3);
+  REQUIRE(avltree.search(2) == nullptr);
+}
+
+SCENARIO("Test Compact AVL Tree") {
+  GIVEN("A Compact AVL Tree") {
+    forest::compact_avltree <int, std::string> avltree;
+    WHEN("The Compact AVL Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(avltree.empty() == true);
+        REQUIRE(avltree.size() == 0);
+        REQUIRE(avltree.height() == 0);
+        REQUIRE(avltree.minimum() == nullptr);
+        REQUIRE(avltree.maximum() == nullptr);
+        REQUIRE(avltree.search(555) == nullptr);
+        REQUIRE(avltree.erase(555) == 0);
+      }
+    }
+    WHEN("Nodes are inserted in random order") {
+      std::vector <int> keys;
+      for (int i = 0; i < 100000; i++) {
+        keys.push_back(i);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937());
+      std::map <int, std::string> map;
+      for (int key : keys) {
+        avltree.insert(key, std::to_string(key));
+        map[key] = std::to_string(key);
+      }
+      THEN("Test the Compact AVL Tree matches a map") {
+        REQUIRE(matches(avltree, map));
+        REQUIRE(avltree.height() <= 24);
+        REQUIRE(avltree.minimum()->key == 0);
+        REQUIRE(avltree.maximum()->key == 99999);
+      }
+      THEN("Test insert overwrites a value") {
+        auto result = avltree.insert(42, "Frigg");
+        REQUIRE(result.second == false);
+        REQUIRE(avltree.search(42)->value == "Frigg");
+        REQUIRE(avltree.size() == 100000);
+      }
+      THEN("Test breadth_first_traversal visits every node") {
+        size_t count {0};
+        avltree.breadth_first_traversal([&](const int &, const std::string &) {
+          count++;
+        });
+        REQUIRE(count == 100000);
+      }
+      THEN("Test pre_order_traversal and post_order_traversal visit every node") {
+        int root {-1};
+        avltree.breadth_first_traversal([&](const int & key, const std::string &) {
+          root = key;
+          return false;
+        });
+        std::vector <int> pre_order;
+        avltree.pre_order_traversal([&](const int & key, const std::string &) {
+          pre_order.push_back(key);
+        });
+        std::vector <int> post_order;
+        avltree.post_order_traversal([&](const int & key, const std::string &) {
+          post_order.push_back(key);
+        });
+        REQUIRE(pre_order.size() == 100000);
+        REQUIRE(pre_order.front() == root);
+        REQUIRE(post_order.back() == root);
+        std::sort(pre_order.begin(), pre_order.end());
+        std::sort(post_order.begin(), post_order.end());
+        REQUIRE(pre_order == post_order);
+        REQUIRE(std::adjacent_find(pre_order.begin(), pre_order.end()) == pre_order.end());
+      }
+      THEN("Test erase until empty") {
+        for (int key : keys) {
+          REQUIRE(avltree.erase(key) == 1);
+          map.erase(key);
+          if (key % 1000 == 0) {
+            REQUIRE(matches(avltree, map));
+          }
+        }
+        REQUIRE(avltree.empty() == true);
+        REQUIRE(avltree.height() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ * @file compact_rbtree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/compact_rbtree.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <typename Tree>
+  bool matches(Tree & tree, const std::map <int, std::string> & map) {
+    if (tree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    tree.in_order_traversal([&](const int & key, const std::string & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+TEST_CASE("Test Compact Red Black Tree Random Operations") {
+  forest::compact_rbtree <int, std::string> rbtree;
+  std::map <int, std::string> map;
+  std::mt19937 generator;
+  for (int i = 0; i < 20000; i++) {
+    int key {static_cast<int>(generator() % 2000)};
+    if (generator() % 3) {
+      auto result = rbtree.insert(key, std::to_string(i));
+      REQUIRE(result.second == (map.count(key) == 0));
+      REQUIRE(result.first->key == key);
+      map[key] = std::to_string(i);
+    } else {
+      REQUIRE(rbtree.erase(key) == map.erase(key));
+    }
+  }
+  REQUIRE(matches(rbtree, map));
+  REQUIRE(rbtree.height() <= 22);
+}
+
+TEST_CASE("Test Compact Red Black Tree Handles Survive Growth") {
+  forest::compact_rbtree <int, std::string> rbtree;
+  auto handle = rbtree.insert(-1, "Thor").first;
+  rbtree.insert(-2, "Odin");
+  for (int i = 0; i < 1000; i++) {
+    rbtree.insert(i, std::string(32, 'a'));
+  }
+  REQUIRE(rbtree.erase(-2) == 1);
+  REQUIRE(handle->value == "Thor");
+  REQUIRE(rbtree.search(-1) == handle);
+  rbtree.reserve(4096);
+  REQUIRE(handle->value == "Thor");
+  rbtree.insert(2000, rbtree.search(-1)->value);
+  REQUIRE(rbtree.search(2000)->value == "Thor");
+}
+
+TEST_CASE("Test Compact Red Black Tree Move Semantics") {
+  forest::compact_rbtree <int, std::string> rbtree({{1, "Thor"}, {2, "Odin"}, {3, "Loki"}});
+  forest::compact_rbtree <int, std::string> moved(std::move(rbtree));
+  REQUIRE(rbtree.empty() == true);
+  REQUIRE(moved.size() == 3);
+  rbtree = std::move(moved);
+  REQUIRE(moved.empty() == true);
+  REQUIRE(rbtree.search(2)->value == "Odin");
+  swap(rbtree, moved);
+  REQUIRE(moved.size() == 3);
+  REQUIRE(rbtree.search(2) == nullptr);
+}
+
+SCENARIO("Test Compact Red Black Tree") {
+  GIVEN("A Compact Red Black Tree") {
+    forest::compact_rbtree <int, std::string> rbtree;
+    WHEN("The Compact Red Black Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.size() == 0);
+        REQUIRE(rbtree.height() == 0);
+        REQUIRE(rbtree.minimum() == nullptr);
+        REQUIRE(rbtree.maximum() == nullptr);
+        REQUIRE(rbtree.search(555) == nullptr);
+        REQUIRE(rbtree.erase(555) == 0);
+      }
+    }
+    WHEN("Nodes are inserted in random order") {
+      std::vector <int> keys;
+      for (int i = 0; i < 100000; i++) {
+        keys.push_back(i);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937());
+      std::map <int, std::string> map;
+      for (int key : keys) {
+        rbtree.insert(key, std::to_string(key));
+        map[key] = std::to_string(key);
+      }
+      THEN("Test the Compact Red Black Tree matches a map") {
+        REQUIRE(matches(rbtree, map));
+        REQUIRE(rbtree.height() <= 34);
+        REQUIRE(rbtree.minimum()->key == 0);
+        REQUIRE(rbtree.maximum()->key == 99999);
+      }
+      THEN("Test insert overwrites a value") {
+        auto result = rbtree.insert(42, "Frigg");
+        REQUIRE(result.second == false);
+        REQUIRE(rbtree.search(42)->value == "Frigg");
+        REQUIRE(rbtree.size() == 100000);
+      }
+      THEN("Test breadth_first_traversal visits every node") {
+        size_t count {0};
+        rbtree.breadth_first_traversal([&](const int &, const std::string &) {
+          count++;
+        });
+        REQUIRE(count == 100000);
+      }
+      THEN("Test pre_order_traversal and post_order_traversal visit every node") {
+        int root {-1};
+        rbtree.breadth_first_traversal([&](const int & key, const std::string &) {
+          root = key;
+          return false;
+        });
+        std::vector <int> pre_order;
+        rbtree.pre_order_traversal([&](const int & key, const std::string &) {
+          pre_order.push_back(key);
+        });
+        std::vector <int> post_order;
+        rbtree.post_order_traversal([&](const int & key, const std::string &) {
+          post_order.push_back(key);
+        });
+        REQUIRE(pre_order.size() == 100000);
+        REQUIRE(pre_order.front() == root);
+        REQUIRE(post_order.back() == root);
+        std::sort(pre_order.begin(), pre_order.end());
+        std::sort(post_order.begin(), post_order.end());
+        REQUIRE(pre_order == post_order);
+        REQUIRE(std::adjacent_find(pre_order.begin(), pre_order.end()) == pre_order.end());
+      }
+      THEN("Test erase until empty") {
+        for (int key : keys) {
+          REQUIRE(rbtree.erase(key) == 1);
+          map.erase(key);
+          if (key % 1000 == 0) {
+            REQUIRE(matches(rbtree, map));
+          }
+        }
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.height() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * @file frozen_map.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/avltree.hpp>
+#include <forest/frozen_map.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/splaytree.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <typename Map>
+  bool matches(const Map & frozen, const std::map <int, int> & map) {
+    if (frozen.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    frozen.in_order_traversal([&](const int & key, const int & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    for (int key = -1; key <= 2001; key++) {
+      auto found = frozen.search(key);
+      auto expected = map.find(key);
+      result = result && (found == nullptr) == (expected == map.end());
+      if (found != nullptr) result = result && found->value == expected->second;
+      auto ceiling = frozen.ceiling(key);
+      auto lower = map.lower_bound(key);
+      result = result && (ceiling == nullptr) == (lower == map.end());
+      if (ceiling != nullptr) result = result && ceiling->key == lower->first;
+      auto upper = frozen.upper_bound(key);
+      auto greater = map.upper_bound(key);
+      result = result && (upper == nullptr) == (greater == map.end());
+      if (upper != nullptr) result = result && upper->key == greater->first;
+    }
+    return result;
+  }
+}
+
+SCENARIO("Test Frozen Map") {
+  GIVEN("An empty Frozen Map") {
+    forest::frozen_map <int, int> frozen;
+    THEN("Test the queries") {
+      REQUIRE(frozen.empty() == true);
+      REQUIRE(frozen.size() == 0);
+      REQUIRE(frozen.search(1) == nullptr);
+      REQUIRE(frozen.minimum() == nullptr);
+      REQUIRE(frozen.maximum() == nullptr);
+    }
+  }
+  GIVEN("Random elements") {
+    std::mt19937 generator;
+    std::vector <std::pair <int, int> > elements;
+    std::map <int, int> map;
+    for (int i = 0; i < 1000; i++) {
+      int key {static_cast<int>(generator() % 2000)};
+      elements.emplace_back(key, i);
+      map[key] = i;
+    }
+    WHEN("A Frozen Map is built from an unsorted range") {
+      forest::frozen_map <int, int> frozen(elements.begin(), elements.end());
+      THEN("Test it matches a map") {
+        REQUIRE(matches(frozen, map));
+        REQUIRE(frozen.minimum()->key == map.begin()->first);
+        REQUIRE(frozen.maximum()->key == map.rbegin()->first);
+      }
+    }
+    WHEN("Trees are frozen") {
+      forest::avltree <int, int> avltree(elements.begin(), elements.end());
+      forest::rbtree <int, int> rbtree(elements.begin(), elements.end());
+      forest::splaytree <int, int> splaytree(elements.begin(), elements.end());
+      THEN("Test every frozen tree matches a map") {
+        REQUIRE(matches(avltree.freeze(), map));
+        REQUIRE(matches(rbtree.freeze(), map));
+        REQUIRE(matches(splaytree.freeze(), map));
+      }
+    }
+  }
+  GIVEN("A Frozen Map with every size up to 64") {
+    THEN("Test every key is found") {
+      for (int n = 1; n <= 64; n++) {
+        std::vector <std::pair <int, std::string> > elements;
+        for (int i = 0; i < n; i++) {
+          elements.emplace_back(i, std::to_string(i));
+        }
+        forest::frozen_map <int, std::string> frozen(elements.begin(), elements.end());
+        for (int i = 0; i < n; i++) {
+          REQUIRE(frozen.search(i)->value == std::to_string(i));
+        }
+        REQUIRE(frozen.search(n) == nullptr);
+        REQUIRE(frozen.maximum()->key == n - 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,191 @@
+/*
+ * @file intrusive_rbtree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/intrusive_rbtree.hpp>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  struct reversed_tag;
+  struct god : forest::intrusive_rbtree_hook <>, forest::intrusive_rbtree_hook <reversed_tag> {
+    int id;
+    std::string name;
+  };
+  struct id_of {
+    const int & operator()(const god & element) const {
+      return element.id;
+    }
+  };
+  struct titan : forest::intrusive_rbtree_hook <> {
+    int id;
+  };
+  struct name_of {
+    std::string operator()(const titan & element) const {
+      return "titan-" + std::to_string(element.id);
+    }
+  };
+  bool matches(forest::intrusive_rbtree <god, id_of> & rbtree, const std::map <int, god *> & map) {
+    if (rbtree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    rbtree.in_order_traversal([&](god & value) {
+      result = result && element->second == &value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+TEST_CASE("Test Intrusive Red Black Tree Random Operations") {
+  std::vector <god> gods(2000);
+  std::vector <bool> linked(gods.size());
+  forest::intrusive_rbtree <god, id_of> rbtree;
+  std::map <int, god *> map;
+  std::mt19937 generator;
+  for (int i = 0; i < 20000; i++) {
+    size_t index {generator() % gods.size()};
+    god & element {gods[index]};
+    if (generator() % 3) {
+      if (linked[index]) continue;
+      element.id = static_cast<int>(generator() % 2000);
+      auto result = rbtree.insert(element);
+      REQUIRE(result.second == (map.count(element.id) == 0));
+      if (result.second) map[element.id] = &element;
+      REQUIRE(result.first == map[element.id]);
+      linked[index] = result.second;
+    } else if (linked[index]) {
+      rbtree.erase(element);
+      map.erase(element.id);
+      linked[index] = false;
+    } else {
+      int key {static_cast<int>(generator() % 2000)};
+      auto position = map.find(key);
+      if (position != map.end()) linked[position->second - gods.data()] = false;
+      REQUIRE(rbtree.erase(key) == map.erase(key));
+    }
+  }
+  REQUIRE(matches(rbtree, map));
+  REQUIRE(rbtree.height() <= 22);
+}
+
+TEST_CASE("Test Intrusive Red Black Tree Hooks") {
+  std::vector <god> gods(3);
+  gods[0].id = 1;
+  gods[0].name = "Thor";
+  gods[1].id = 2;
+  gods[1].name = "Odin";
+  gods[2].id = 3;
+  gods[2].name = "Loki";
+  forest::intrusive_rbtree <god, id_of> rbtree(gods.begin(), gods.end());
+  forest::intrusive_rbtree <god, id_of, std::greater <int>, reversed_tag> reversed(gods.begin(), gods.end());
+  REQUIRE(rbtree.search(2) == &gods[1]);
+  REQUIRE(rbtree.minimum()->name == "Thor");
+  REQUIRE(reversed.minimum()->name == "Loki");
+  god copy {gods[1]};
+  copy.id = 4;
+  REQUIRE(rbtree.insert(copy).second == true);
+  REQUIRE(rbtree.maximum() == &copy);
+  REQUIRE(rbtree.search(2) == &gods[1]);
+  forest::intrusive_rbtree <god, id_of> moved(std::move(rbtree));
+  REQUIRE(rbtree.empty() == true);
+  REQUIRE(moved.size() == 4);
+  swap(rbtree, moved);
+  REQUIRE(rbtree.size() == 4);
+  REQUIRE(rbtree.search(4) == &copy);
+}
+
+TEST_CASE("Test Intrusive Red Black Tree By Value Key") {
+  std::vector <titan> titans(1000);
+  for (int i = 0; i < 1000; i++) {
+    titans[i].id = i;
+  }
+  std::shuffle(titans.begin(), titans.end(), std::mt19937());
+  forest::intrusive_rbtree <titan, name_of> rbtree(titans.begin(), titans.end());
+  REQUIRE(rbtree.size() == 1000);
+  titan duplicate;
+  duplicate.id = 42;
+  REQUIRE(rbtree.insert(duplicate).second == false);
+  REQUIRE(rbtree.search("titan-42")->id == 42);
+  REQUIRE(rbtree.search("titan-1000") == nullptr);
+  REQUIRE(rbtree.minimum()->id == 0);
+  REQUIRE(rbtree.maximum()->id == 999);
+  std::string previous;
+  bool sorted {true};
+  rbtree.in_order_traversal([&](titan & element) {
+    std::string current {name_of()(element)};
+    sorted = sorted && previous < current;
+    previous = current;
+  });
+  REQUIRE(sorted == true);
+  REQUIRE(rbtree.erase("titan-500") == 1);
+  REQUIRE(rbtree.search("titan-500") == nullptr);
+  REQUIRE(rbtree.size() == 999);
+}
+
+SCENARIO("Test Intrusive Red Black Tree") {
+  GIVEN("An Intrusive Red Black Tree") {
+    forest::intrusive_rbtree <god, id_of> rbtree;
+    WHEN("The Intrusive Red Black Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.size() == 0);
+        REQUIRE(rbtree.height() == 0);
+        REQUIRE(rbtree.minimum() == nullptr);
+        REQUIRE(rbtree.maximum() == nullptr);
+        REQUIRE(rbtree.search(555) == nullptr);
+        REQUIRE(rbtree.erase(555) == 0);
+      }
+    }
+    WHEN("Nodes are inserted in random order") {
+      std::vector <god> gods(100000);
+      for (int i = 0; i < 100000; i++) {
+        gods[i].id = i;
+      }
+      std::shuffle(gods.begin(), gods.end(), std::mt19937());
+      std::map <int, god *> map;
+      for (god & element : gods) {
+        rbtree.insert(element);
+        map[element.id] = &element;
+      }
+      THEN("Test the Intrusive Red Black Tree matches a map") {
+        REQUIRE(matches(rbtree, map));
+        REQUIRE(rbtree.height() <= 34);
+        REQUIRE(rbtree.minimum()->id == 0);
+        REQUIRE(rbtree.maximum()->id == 99999);
+      }
+      THEN("Test insert keeps the linked element") {
+        god duplicate;
+        duplicate.id = 42;
+        auto result = rbtree.insert(duplicate);
+        REQUIRE(result.second == false);
+        REQUIRE(result.first == map[42]);
+        REQUIRE(rbtree.size() == 100000);
+      }
+      THEN("Test breadth_first_traversal visits every node") {
+        size_t count {0};
+        rbtree.breadth_first_traversal([&](god &) {
+          count++;
+        });
+        REQUIRE(count == 100000);
+      }
+      THEN("Test erase until empty") {
+        for (god & element : gods) {
+          rbtree.erase(element);
+          map.erase(element.id);
+          if (element.id % 1000 == 0) {
+            REQUIRE(matches(rbtree, map));
+          }
+        }
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.height() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,189 @@
+/*
+ * @file intrusive_splaytree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/intrusive_splaytree.hpp>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  struct reversed_tag;
+  struct god : forest::intrusive_splaytree_hook <>, forest::intrusive_splaytree_hook <reversed_tag> {
+    int id;
+    std::string name;
+  };
+  struct id_of {
+    const int & operator()(const god & element) const {
+      return element.id;
+    }
+  };
+  struct titan : forest::intrusive_splaytree_hook <> {
+    int id;
+  };
+  struct name_of {
+    std::string operator()(const titan & element) const {
+      return "titan-" + std::to_string(element.id);
+    }
+  };
+  bool matches(forest::intrusive_splaytree <god, id_of> & splaytree, const std::map <int, god *> & map) {
+    if (splaytree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    splaytree.in_order_traversal([&](god & value) {
+      result = result && element->second == &value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+TEST_CASE("Test Intrusive Splay Tree Random Operations") {
+  std::vector <god> gods(2000);
+  std::vector <bool> linked(gods.size());
+  forest::intrusive_splaytree <god, id_of> splaytree;
+  std::map <int, god *> map;
+  std::mt19937 generator;
+  for (int i = 0; i < 20000; i++) {
+    size_t index {generator() % gods.size()};
+    god & element {gods[index]};
+    if (generator() % 3) {
+      if (linked[index]) continue;
+      element.id = static_cast<int>(generator() % 2000);
+      auto result = splaytree.insert(element);
+      REQUIRE(result.second == (map.count(element.id) == 0));
+      if (result.second) map[element.id] = &element;
+      REQUIRE(result.first == map[element.id]);
+      linked[index] = result.second;
+    } else if (linked[index]) {
+      splaytree.erase(element);
+      map.erase(element.id);
+      linked[index] = false;
+    } else {
+      int key {static_cast<int>(generator() % 2000)};
+      auto position = map.find(key);
+      if (position != map.end()) linked[position->second - gods.data()] = false;
+      REQUIRE(splaytree.erase(key) == map.erase(key));
+    }
+  }
+  REQUIRE(matches(splaytree, map));
+}
+
+TEST_CASE("Test Intrusive Splay Tree Hooks") {
+  std::vector <god> gods(3);
+  gods[0].id = 1;
+  gods[0].name = "Thor";
+  gods[1].id = 2;
+  gods[1].name = "Odin";
+  gods[2].id = 3;
+  gods[2].name = "Loki";
+  forest::intrusive_splaytree <god, id_of> splaytree(gods.begin(), gods.end());
+  forest::intrusive_splaytree <god, id_of, std::greater <int>, reversed_tag> reversed(gods.begin(), gods.end());
+  REQUIRE(splaytree.search(2) == &gods[1]);
+  REQUIRE(splaytree.minimum()->name == "Thor");
+  REQUIRE(reversed.minimum()->name == "Loki");
+  god copy {gods[1]};
+  copy.id = 4;
+  REQUIRE(splaytree.insert(copy).second == true);
+  REQUIRE(splaytree.maximum() == &copy);
+  REQUIRE(splaytree.search(2) == &gods[1]);
+  forest::intrusive_splaytree <god, id_of> moved(std::move(splaytree));
+  REQUIRE(splaytree.empty() == true);
+  REQUIRE(moved.size() == 4);
+  swap(splaytree, moved);
+  REQUIRE(splaytree.size() == 4);
+  REQUIRE(splaytree.search(4) == &copy);
+}
+
+TEST_CASE("Test Intrusive Splay Tree By Value Key") {
+  std::vector <titan> titans(1000);
+  for (int i = 0; i < 1000; i++) {
+    titans[i].id = i;
+  }
+  std::shuffle(titans.begin(), titans.end(), std::mt19937());
+  forest::intrusive_splaytree <titan, name_of> splaytree(titans.begin(), titans.end());
+  REQUIRE(splaytree.size() == 1000);
+  titan duplicate;
+  duplicate.id = 42;
+  REQUIRE(splaytree.insert(duplicate).second == false);
+  REQUIRE(splaytree.search("titan-42")->id == 42);
+  REQUIRE(splaytree.search("titan-1000") == nullptr);
+  REQUIRE(splaytree.minimum()->id == 0);
+  REQUIRE(splaytree.maximum()->id == 999);
+  std::string previous;
+  bool sorted {true};
+  splaytree.in_order_traversal([&](titan & element) {
+    std::string current {name_of()(element)};
+    sorted = sorted && previous < current;
+    previous = current;
+  });
+  REQUIRE(sorted == true);
+  REQUIRE(splaytree.erase("titan-500") == 1);
+  REQUIRE(splaytree.search("titan-500") == nullptr);
+  REQUIRE(splaytree.size() == 999);
+}
+
+SCENARIO("Test Intrusive Splay Tree") {
+  GIVEN("An Intrusive Splay Tree") {
+    forest::intrusive_splaytree <god, id_of> splaytree;
+    WHEN("The Intrusive Splay Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(splaytree.empty() == true);
+        REQUIRE(splaytree.size() == 0);
+        REQUIRE(splaytree.height() == 0);
+        REQUIRE(splaytree.minimum() == nullptr);
+        REQUIRE(splaytree.maximum() == nullptr);
+        REQUIRE(splaytree.search(555) == nullptr);
+        REQUIRE(splaytree.erase(555) == 0);
+      }
+    }
+    WHEN("Nodes are inserted in random order") {
+      std::vector <god> gods(100000);
+      for (int i = 0; i < 100000; i++) {
+        gods[i].id = i;
+      }
+      std::shuffle(gods.begin(), gods.end(), std::mt19937());
+      std::map <int, god *> map;
+      for (god & element : gods) {
+        splaytree.insert(element);
+        map[element.id] = &element;
+      }
+      THEN("Test the Intrusive Splay Tree matches a map") {
+        REQUIRE(matches(splaytree, map));
+        REQUIRE(splaytree.minimum()->id == 0);
+        REQUIRE(splaytree.maximum()->id == 99999);
+      }
+      THEN("Test insert keeps the linked element") {
+        god duplicate;
+        duplicate.id = 42;
+        auto result = splaytree.insert(duplicate);
+        REQUIRE(result.second == false);
+        REQUIRE(result.first == map[42]);
+        REQUIRE(splaytree.size() == 100000);
+      }
+      THEN("Test breadth_first_traversal visits every node") {
+        size_t count {0};
+        splaytree.breadth_first_traversal([&](god &) {
+          count++;
+        });
+        REQUIRE(count == 100000);
+      }
+      THEN("Test erase until empty") {
+        for (god & element : gods) {
+          splaytree.erase(element);
+          map.erase(element.id);
+          if (element.id % 1000 == 0) {
+            REQUIRE(matches(splaytree, map));
+          }
+        }
+        REQUIRE(splaytree.empty() == true);
+        REQUIRE(splaytree.height() == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ * @file persistent_rbtree.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/persistent_rbtree.hpp>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  template <typename Tree>
+  bool matches(const Tree & tree, const std::map <int, int> & map) {
+    if (tree.size() != map.size()) return false;
+    auto element = map.begin();
+    bool result {true};
+    tree.in_order_traversal([&](const int & key, const int & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    return result;
+  }
+}
+
+SCENARIO("Test Persistent Red Black Tree") {
+  GIVEN("A Persistent Red Black Tree") {
+    forest::persistent_rbtree <int, int> tree;
+    WHEN("The Persistent Red Black Tree is empty") {
+      THEN("Test the queries") {
+        REQUIRE(tree.empty() == true);
+        REQUIRE(tree.size() == 0);
+        REQUIRE(tree.height() == 0);
+        REQUIRE(tree.root() == nullptr);
+        REQUIRE(tree.minimum() == nullptr);
+        REQUIRE(tree.maximum() == nullptr);
+        REQUIRE(tree.search(1) == nullptr);
+        REQUIRE(tree.select(0) == nullptr);
+        REQUIRE(tree.erase(1) == 0);
+      }
+    }
+    WHEN("Nodes are inserted and erased in random order") {
+      std::mt19937 generator;
+      std::map <int, int> map;
+      std::vector <forest::persistent_rbtree <int, int> > snapshots;
+      std::vector <std::map <int, int> > expected;
+      for (int i = 0; i < 20000; i++) {
+        int key {static_cast<int>(generator() % 1000)};
+        if (generator() % 2) {
+          REQUIRE(tree.insert(key, i) == (map.count(key) == 0));
+          map[key] = i;
+        } else {
+          REQUIRE(tree.erase(key) == map.erase(key));
+        }
+        if (i % 1000 == 0) {
+          snapshots.push_back(tree.snapshot());
+          expected.push_back(map);
+        }
+      }
+      THEN("Test the tree matches a map") {
+        REQUIRE(matches(tree, map));
+        REQUIRE(tree.height() <= 2 * std::log2(tree.size() + 1));
+        REQUIRE(tree.minimum()->key == map.begin()->first);
+        REQUIRE(tree.maximum()->key == map.rbegin()->first);
+        REQUIRE(tree.select(10)->key == std::next(map.begin(), 10)->first);
+        REQUIRE(tree.rank(500) == static_cast<size_t>(std::distance(map.begin(), map.lower_bound(500))));
+      }
+      THEN("Test every snapshot keeps its version") {
+        for (size_t i = 0; i < snapshots.size(); i++) {
+          REQUIRE(matches(snapshots[i], expected[i]));
+        }
+      }
+      THEN("Test erase until empty") {
+        for (auto element : map) {
+          REQUIRE(tree.erase(element.first) == 1);
+        }
+        REQUIRE(tree.empty() == true);
+        REQUIRE(matches(snapshots.back(), expected.back()));
+      }
+    }
+    WHEN("A lookup result is kept across later writes") {
+      for (int i = 0; i < 8; i++) {
+        tree.insert(i, i * 10);
+      }
+      auto found = tree.search(3);
+      auto smallest = tree.minimum();
+      auto largest = tree.maximum();
+      auto selected = tree.select(5);
+      auto root = tree.root();
+      tree.insert(100, 1);
+      tree.insert(3, 99);
+      REQUIRE(tree.erase(0) == 1);
+      tree.clear();
+      THEN("Test the results still read their own version") {
+        REQUIRE(found->key == 3);
+        REQUIRE(found->value == 30);
+        REQUIRE(smallest->key == 0);
+        REQUIRE(largest->value == 70);
+        REQUIRE(selected->key == 5);
+        REQUIRE(root != nullptr);
+        REQUIRE(tree.empty() == true);
+      }
+    }
+    WHEN("A reader takes snapshots while a writer inserts") {
+      std::atomic <bool> done {false};
+      std::atomic <bool> consistent {true};
+      std::thread reader([&] {
+        while (!done) {
+          auto snapshot = tree.snapshot();
+          size_t count {0};
+          int previous {-1};
+          snapshot.in_order_traversal([&](const int & key, const int & value) {
+            if (key <= previous || key != value) consistent = false;
+            previous = key;
+            count++;
+          });
+          if (count != snapshot.size()) consistent = false;
+        }
+      });
+      for (int i = 0; i < 20000; i++) {
+        tree.insert(i, i);
+      }
+      done = true;
+      reader.join();
+      THEN("Test every snapshot was consistent") {
+        REQUIRE(consistent == true);
+        REQUIRE(tree.size() == 20000);
+      }
+    }
+  }
+}
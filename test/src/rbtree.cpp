@@ -5,9 +5,84 @@
 
 #include <catch2/catch.hpp>
 #include <forest/rbtree.hpp>
+#include <forest/thread_pool.hpp>
+#include <forest/splaytree.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
-auto handler = [](const int & key, const int & value) {};
+namespace {
+  class less_only {
+  public:
+    explicit less_only(int VALUE) : value(VALUE) {
+
+    }
+    bool operator<(const less_only & other) const {
+      return value < other.value;
+    }
+    int value;
+  };
+
+  class counting_less {
+  public:
+    explicit counting_less(size_t * COUNT) : count(COUNT) {
+
+    }
+    bool operator()(int lhs, int rhs) const {
+      (*count)++;
+      return lhs < rhs;
+    }
+    size_t * count;
+  };
+
+  int copies {0};
+
+  class copy_counter {
+  public:
+    copy_counter() = default;
+    copy_counter(const copy_counter &) {
+      copies++;
+    }
+    copy_counter(copy_counter &&) = default;
+    copy_counter& operator=(const copy_counter &) {
+      copies++;
+      return *this;
+    }
+    copy_counter& operator=(copy_counter &&) = default;
+  };
+
+  int live_nodes {0};
+
+  template <typename V>
+  class counting_allocator : public std::allocator <V> {
+  public:
+    template <typename W>
+    struct rebind {
+      using other = counting_allocator <W>;
+    };
+    counting_allocator() = default;
+    template <typename W>
+    counting_allocator(const counting_allocator <W> &) noexcept {
+
+    }
+    V * allocate(size_t n) {
+      live_nodes += static_cast<int>(n);
+      return std::allocator <V>::allocate(n);
+    }
+    void deallocate(V * storage, size_t n) {
+      live_nodes -= static_cast<int>(n);
+      std::allocator <V>::deallocate(storage, n);
+    }
+  };
+}
+
+static auto handler = [](const int & key, const int & value) {};
 
 TEST_CASE("Test Red Black Tree Constructor") {
   forest::rbtree <int, std::string> rbtree({
@@ -28,6 +103,518 @@ TEST_CASE("Test Red Black Tree Constructor") {
   REQUIRE(rbtree.search(45)->value == "Heimdall");
 }
 
+TEST_CASE("Test Red Black Tree Allocator") {
+  {
+    forest::rbtree <int, std::string, std::less <int>, counting_allocator <std::pair <const int, std::string> > > rbtree;
+    for (int i = 0; i < 100; i++) {
+      rbtree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 0; i < 50; i++) {
+      rbtree.erase(i);
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 100; i < 150; i++) {
+      rbtree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+  }
+  REQUIRE(live_nodes == 0);
+}
+
+TEST_CASE("Test Red Black Tree Comparator") {
+  SECTION("Test a reversed order") {
+    forest::rbtree <int, int, std::greater <int> > rbtree({{1, 1}, {2, 2}, {3, 3}, {4, 4}});
+    std::vector <int> keys;
+    for (auto & node : rbtree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {4, 3, 2, 1});
+    REQUIRE(rbtree.minimum()->key == 4);
+    REQUIRE(rbtree.search(3)->value == 3);
+    REQUIRE(rbtree.rank(2) == 2);
+  }
+  SECTION("Test keys that only define operator<") {
+    forest::rbtree <less_only, int> rbtree;
+    rbtree.insert(less_only(2), 2);
+    rbtree.insert(less_only(1), 1);
+    rbtree.insert(less_only(2), 3);
+    REQUIRE(rbtree.size() == 2);
+    REQUIRE(rbtree.search(less_only(2))->value == 3);
+    REQUIRE(rbtree.search(less_only(5)) == nullptr);
+    REQUIRE(rbtree.erase(less_only(1)) == 1);
+  }
+  SECTION("Test one comparison per level") {
+    size_t count {0};
+    forest::rbtree <int, int, counting_less> rbtree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      rbtree.insert((i * 7919) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i++) {
+      count = 0;
+      REQUIRE(rbtree.search(i) != nullptr);
+      REQUIRE(count <= rbtree.height() + 1);
+    }
+  }
+}
+
+TEST_CASE("Test Red Black Tree Move Semantics") {
+  SECTION("Test move-only values") {
+    forest::rbtree <int, std::unique_ptr <int> > rbtree;
+    REQUIRE(rbtree.insert(1, std::unique_ptr <int>(new int(1))).second == true);
+    REQUIRE(rbtree.insert(1, std::unique_ptr <int>(new int(2))).second == false);
+    REQUIRE(*rbtree.search(1)->value == 2);
+    REQUIRE(rbtree.try_emplace(2, new int(3)).second == true);
+    REQUIRE(*rbtree.search(2)->value == 3);
+  }
+  SECTION("Test try_emplace leaves its arguments alone when the key exists") {
+    forest::rbtree <int, std::unique_ptr <int> > rbtree;
+    rbtree.try_emplace(1, new int(1));
+    std::unique_ptr <int> value(new int(2));
+    auto result = rbtree.try_emplace(1, std::move(value));
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->key == 1);
+    REQUIRE(value != nullptr);
+    REQUIRE(*rbtree.search(1)->value == 1);
+  }
+  SECTION("Test insert_or_assign") {
+    forest::rbtree <int, std::string> rbtree;
+    REQUIRE(rbtree.insert_or_assign(1, "Thor").second == true);
+    auto result = rbtree.insert_or_assign(1, "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "Odin");
+    REQUIRE(rbtree.size() == 1);
+  }
+  SECTION("Test emplace") {
+    forest::rbtree <std::string, std::string> rbtree;
+    REQUIRE(rbtree.emplace("Thor", 3, 'a').second == true);
+    REQUIRE(rbtree.search("Thor")->value == "aaa");
+    auto result = rbtree.emplace("Thor", "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "aaa");
+    REQUIRE(rbtree.size() == 1);
+  }
+  SECTION("Test move construction") {
+    forest::rbtree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    auto root = source.root();
+    forest::rbtree <int, int> rbtree(std::move(source));
+    REQUIRE(rbtree.root() == root);
+    REQUIRE(rbtree.size() == 3);
+    REQUIRE(source.empty() == true);
+    source.insert(4, 4);
+    REQUIRE(source.size() == 1);
+  }
+  SECTION("Test move assignment") {
+    forest::rbtree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    forest::rbtree <int, int> rbtree({{4, 4}});
+    rbtree = std::move(source);
+    REQUIRE(rbtree.size() == 3);
+    REQUIRE(rbtree.search(4) == nullptr);
+    REQUIRE(rbtree.search(2)->value == 2);
+    REQUIRE(source.empty() == true);
+  }
+  SECTION("Test swap") {
+    forest::rbtree <int, int> first({{1, 1}, {2, 2}, {3, 3}});
+    forest::rbtree <int, int> second({{4, 4}});
+    swap(first, second);
+    REQUIRE(first.size() == 1);
+    REQUIRE(first.search(4) != nullptr);
+    REQUIRE(second.size() == 3);
+    REQUIRE(second.search(1) != nullptr);
+  }
+  SECTION("Test trees in a vector") {
+    std::vector <forest::rbtree <int, int> > trees;
+    for (int i = 0; i < 10; i++) {
+      trees.emplace_back();
+      trees.back().insert(i, i);
+    }
+    for (int i = 0; i < 10; i++) {
+      REQUIRE(trees[i].search(i) != nullptr);
+      REQUIRE(trees[i].size() == 1);
+    }
+  }
+  SECTION("Test rvalues are not copied") {
+    forest::rbtree <int, copy_counter> rbtree;
+    copies = 0;
+    for (int i = 0; i < 10; i++) {
+      rbtree.insert(i, copy_counter());
+      rbtree.insert_or_assign(i, copy_counter());
+      rbtree.try_emplace(i + 10);
+    }
+    REQUIRE(copies == 0);
+    REQUIRE(rbtree.size() == 20);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Bulk Construction") {
+  SECTION("Test a sorted range") {
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 1000; i++) {
+      elements.emplace_back(i, i * 2);
+    }
+    forest::rbtree <int, int> rbtree(elements.begin(), elements.end());
+    REQUIRE(rbtree.size() == 1000);
+    REQUIRE(rbtree.height() == 10);
+    REQUIRE(rbtree.root()->key == 500);
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(rbtree.search(i)->value == i * 2);
+      REQUIRE(rbtree.select(i)->key == i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(rbtree.erase(i) == 1);
+    }
+    for (int i = 1000; i < 1100; i++) {
+      rbtree.insert(i, i);
+    }
+    REQUIRE(rbtree.size() == 600);
+    REQUIRE(rbtree.rank(1000) == 500);
+  }
+  SECTION("Test an unsorted range with duplicate keys") {
+    std::vector <std::pair <int, std::string> > elements {{3, "Baldr"}, {1, "Thor"}, {3, "Frigg"}, {2, "Odin"}, {1, "Loki"}};
+    forest::rbtree <int, std::string> rbtree(elements.begin(), elements.end());
+    REQUIRE(rbtree.size() == 3);
+    REQUIRE(rbtree.search(1)->value == "Loki");
+    REQUIRE(rbtree.search(2)->value == "Odin");
+    REQUIRE(rbtree.search(3)->value == "Frigg");
+  }
+  SECTION("Test a parallel build from an unsorted range") {
+    forest::thread_pool pool(2);
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 50000; i++) {
+      elements.emplace_back((i * 7919) % 40000, i);
+    }
+    forest::rbtree <int, int> rbtree(elements.begin(), elements.end(), pool);
+    REQUIRE(rbtree.size() == 40000);
+    for (int i = 0; i < 40000; i++) {
+      REQUIRE(rbtree.select(i)->key == i);
+    }
+    for (int i = 10000; i < 50000; i++) {
+      REQUIRE(rbtree.search((i * 7919) % 40000)->value == i);
+    }
+    rbtree.assign(elements.begin(), elements.begin() + 100, pool);
+    REQUIRE(rbtree.size() == 100);
+    REQUIRE(rbtree.search(0)->value == 0);
+  }
+  SECTION("Test assign replaces the contents") {
+    forest::rbtree <int, int> rbtree({{1, 1}, {2, 2}, {3, 3}});
+    std::vector <std::pair <int, int> > elements {{4, 4}, {5, 5}};
+    rbtree.assign(elements.begin(), elements.end());
+    REQUIRE(rbtree.size() == 2);
+    REQUIRE(rbtree.search(1) == nullptr);
+    REQUIRE(rbtree.minimum()->key == 4);
+    rbtree.assign(elements.end(), elements.end());
+    REQUIRE(rbtree.empty() == true);
+  }
+  SECTION("Test converting from another tree") {
+    forest::splaytree <int, std::string> source({{2, "Thor"}, {4, "Odin"}, {90, "Loki"}, {3, "Baldr"}});
+    forest::rbtree <int, std::string> rbtree(source.begin(), source.end());
+    REQUIRE(rbtree.size() == 4);
+    REQUIRE(rbtree.search(90)->value == "Loki");
+    REQUIRE(rbtree.minimum()->key == 2);
+    REQUIRE(rbtree.maximum()->key == 90);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Parallel Traversal") {
+  forest::thread_pool pool(2);
+  forest::rbtree <int, int> rbtree;
+  REQUIRE(rbtree.parallel_reduce(0L, [](const int & key, const int &) {
+    return static_cast<long>(key);
+  }, std::plus <long>(), pool) == 0);
+  for (int i = 0; i < 20000; i++) {
+    rbtree.insert((i * 7919) % 20000, i % 10);
+  }
+  SECTION("Test parallel_for_each visits every node") {
+    std::atomic <long> sum {0};
+    rbtree.parallel_for_each([&](const int & key, const int &) {
+      sum += key;
+    }, pool);
+    REQUIRE(sum == 199990000L);
+  }
+  SECTION("Test parallel_reduce combines in key order") {
+    std::string expected;
+    rbtree.in_order_traversal([&](const int &, const int & value) {
+      expected += std::to_string(value);
+    });
+    std::string digits {rbtree.parallel_reduce(std::string(), [](const int &, const int & value) {
+      return std::to_string(value);
+    }, [](std::string lhs, const std::string & rhs) {
+      return lhs += rhs;
+    }, pool)};
+    REQUIRE(digits == expected);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Split And Join") {
+  forest::rbtree <int, int> rbtree;
+  for (int i = 0; i < 1000; i++) {
+    rbtree.insert(i, i);
+  }
+  SECTION("Test split") {
+    auto parts = rbtree.split(300);
+    REQUIRE(rbtree.empty() == true);
+    REQUIRE(parts.first.size() == 300);
+    REQUIRE(parts.second.size() == 700);
+    REQUIRE(parts.first.maximum()->key == 299);
+    REQUIRE(parts.second.minimum()->key == 300);
+    REQUIRE(parts.first.height() <= 2 * std::log2(parts.first.size() + 1));
+    REQUIRE(parts.second.height() <= 2 * std::log2(parts.second.size() + 1));
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE((i < 300 ? parts.first : parts.second).search(i)->value == i);
+    }
+    REQUIRE(parts.first.rank(150) == 150);
+    REQUIRE(parts.second.select(0)->key == 300);
+    parts.first.insert(1000, 1000);
+    REQUIRE(parts.first.maximum()->key == 1000);
+  }
+  SECTION("Test split at the ends") {
+    auto low = rbtree.split(-1);
+    REQUIRE(low.first.empty() == true);
+    REQUIRE(low.second.size() == 1000);
+    auto high = low.second.split(1000);
+    REQUIRE(high.first.size() == 1000);
+    REQUIRE(high.second.empty() == true);
+  }
+  SECTION("Test join") {
+    auto parts = rbtree.split(500);
+    parts.second.erase(500);
+    auto joined = forest::rbtree <int, int>::join(std::move(parts.first), 500, -1, std::move(parts.second));
+    REQUIRE(joined.size() == 1000);
+    REQUIRE(joined.search(500)->value == -1);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    int expected {0};
+    for (auto & node : joined) {
+      REQUIRE(node.key == expected++);
+    }
+  }
+  SECTION("Test join of trees with different heights") {
+    forest::rbtree <int, int> small({{2000, 2000}});
+    auto joined = forest::rbtree <int, int>::join(std::move(rbtree), 1500, 1500, std::move(small));
+    REQUIRE(joined.size() == 1002);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    REQUIRE(joined.rank(1500) == 1000);
+    REQUIRE(joined.maximum()->key == 2000);
+  }
+  SECTION("Test concat") {
+    auto parts = rbtree.split(10);
+    auto joined = forest::rbtree <int, int>::concat(std::move(parts.second), forest::rbtree <int, int>());
+    joined = forest::rbtree <int, int>::concat(std::move(parts.first), std::move(joined));
+    REQUIRE(joined.size() == 1000);
+    REQUIRE(joined.height() <= 2 * std::log2(joined.size() + 1));
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(joined.select(i)->key == i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(joined.erase(i) == 1);
+    }
+    REQUIRE(joined.size() == 500);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Set Operations") {
+  forest::thread_pool pool(2);
+  std::mt19937 generator(11);
+  std::uniform_int_distribution <int> distribution(0, 39999);
+  forest::rbtree <int, int> first;
+  forest::rbtree <int, int> second;
+  std::map <int, int> first_map;
+  std::map <int, int> second_map;
+  for (int i = 0; i < 20000; i++) {
+    int key {distribution(generator)};
+    first.insert(key, 1);
+    first_map[key] = 1;
+    key = distribution(generator);
+    second.insert(key, 2);
+    second_map[key] = 2;
+  }
+  auto require_equal = [](forest::rbtree <int, int> & rbtree, const std::map <int, int> & map) {
+    REQUIRE(rbtree.size() == map.size());
+    REQUIRE(rbtree.height() <= 2 * std::log2(rbtree.size() + 1));
+    auto it = map.begin();
+    for (auto & node : rbtree) {
+      REQUIRE(node.key == it->first);
+      REQUIRE(node.value == it->second);
+      ++it;
+    }
+  };
+  SECTION("Test union_with") {
+    std::map <int, int> expected {first_map};
+    for (const auto & element : second_map) {
+      expected[element.first] = element.second;
+    }
+    first.union_with(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test intersect_with") {
+    std::map <int, int> expected;
+    for (const auto & element : first_map) {
+      if (second_map.count(element.first)) expected.insert(element);
+    }
+    first.intersect_with(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test difference") {
+    std::map <int, int> expected;
+    for (const auto & element : first_map) {
+      if (!second_map.count(element.first)) expected.insert(element);
+    }
+    first.difference(std::move(second), pool);
+    require_equal(first, expected);
+    REQUIRE(second.empty() == true);
+  }
+  SECTION("Test without a thread pool") {
+    std::map <int, int> expected {second_map};
+    for (const auto & element : first_map) {
+      expected[element.first] = element.second;
+    }
+    second.union_with(std::move(first));
+    require_equal(second, expected);
+    second.difference(forest::rbtree <int, int>({{0, 0}, {1, 0}}));
+    expected.erase(0);
+    expected.erase(1);
+    require_equal(second, expected);
+    second.intersect_with(forest::rbtree <int, int>());
+    REQUIRE(second.empty() == true);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Bounds") {
+  forest::rbtree <int, int> rbtree;
+  std::map <int, int> map;
+  for (int i = 0; i < 200; i += 3) {
+    rbtree.insert(i, i);
+    map[i] = i;
+  }
+  SECTION("Test lower_bound, upper_bound and equal_range") {
+    for (int i = -5; i < 210; i++) {
+      auto lower = rbtree.lower_bound(i);
+      auto upper = rbtree.upper_bound(i);
+      auto range = rbtree.equal_range(i);
+      REQUIRE((lower == rbtree.end()) == (map.lower_bound(i) == map.end()));
+      REQUIRE((upper == rbtree.end()) == (map.upper_bound(i) == map.end()));
+      if (lower != rbtree.end()) REQUIRE(lower->key == map.lower_bound(i)->first);
+      if (upper != rbtree.end()) REQUIRE(upper->key == map.upper_bound(i)->first);
+      REQUIRE(range.first == lower);
+      REQUIRE(range.second == upper);
+      REQUIRE(std::distance(range.first, range.second) == static_cast<std::ptrdiff_t>(map.count(i)));
+    }
+  }
+  SECTION("Test floor and ceiling") {
+    REQUIRE(rbtree.floor(-1) == nullptr);
+    REQUIRE(rbtree.floor(0)->key == 0);
+    REQUIRE(rbtree.floor(5)->key == 3);
+    REQUIRE(rbtree.floor(1000)->key == 198);
+    REQUIRE(rbtree.ceiling(-1)->key == 0);
+    REQUIRE(rbtree.ceiling(4)->key == 6);
+    REQUIRE(rbtree.ceiling(6)->key == 6);
+    REQUIRE(rbtree.ceiling(199) == nullptr);
+  }
+  SECTION("Test for_each_in_range") {
+    std::vector <int> keys;
+    rbtree.for_each_in_range(10, 22, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys == std::vector <int> {12, 15, 18, 21});
+    keys.clear();
+    rbtree.for_each_in_range(12, 12, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys.empty() == true);
+    rbtree.for_each_in_range(0, 1000, [&](const int & key, const int & value) {
+      keys.push_back(key);
+      return keys.size() < 3;
+    });
+    REQUIRE(keys == std::vector <int> {0, 3, 6});
+  }
+}
+
+TEST_CASE("Test Red Black Tree Hinted Insert") {
+  SECTION("Test appends cost one comparison") {
+    size_t count {0};
+    forest::rbtree <int, int, counting_less> rbtree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      rbtree.insert(i, i);
+    }
+    REQUIRE(count < 1000);
+    REQUIRE(rbtree.size() == 1000);
+    REQUIRE(rbtree.maximum()->key == 999);
+    REQUIRE(rbtree.erase(999) == 1);
+    REQUIRE(rbtree.maximum()->key == 998);
+    rbtree.insert(500, 0);
+    REQUIRE(rbtree.maximum()->key == 998);
+    REQUIRE(rbtree.search(500)->value == 0);
+  }
+  SECTION("Test a correct hint") {
+    size_t count {0};
+    forest::rbtree <int, int, counting_less> rbtree((counting_less(&count)));
+    for (int i = 0; i < 1000; i += 2) {
+      rbtree.insert(i, i);
+    }
+    for (int i = 1; i < 1000; i += 2) {
+      auto hint = rbtree.search(i + 1);
+      count = 0;
+      auto result = rbtree.insert(hint, i, i);
+      REQUIRE(count <= 3);
+      REQUIRE(result->key == i);
+    }
+    REQUIRE(rbtree.size() == 1000);
+    int expected {0};
+    for (auto & node : rbtree) {
+      REQUIRE(node.key == expected++);
+    }
+  }
+  SECTION("Test a wrong hint") {
+    forest::rbtree <int, int> rbtree({{1, 1}, {5, 5}, {9, 9}});
+    REQUIRE(rbtree.insert(rbtree.begin(), 7, 7)->key == 7);
+    REQUIRE(rbtree.insert(rbtree.end(), 3, 3)->key == 3);
+    REQUIRE(rbtree.insert(rbtree.end(), 10, 10)->key == 10);
+    REQUIRE(rbtree.insert(rbtree.search(9), 9, 0)->value == 0);
+    REQUIRE(rbtree.size() == 6);
+    std::vector <int> keys;
+    for (auto & node : rbtree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {1, 3, 5, 7, 9, 10});
+    REQUIRE((--rbtree.end())->key == 10);
+  }
+}
+
+TEST_CASE("Test Red Black Tree Batch Insert") {
+  std::mt19937 generator(7);
+  std::uniform_int_distribution <int> distribution(0, 99999);
+  forest::rbtree <int, int> rbtree;
+  std::map <int, int> map;
+  auto insert_batch = [&](size_t count) {
+    std::vector <std::pair <int, int> > batch;
+    for (size_t i = 0; i < count; i++) {
+      batch.emplace_back(distribution(generator), distribution(generator));
+      map[batch.back().first] = batch.back().second;
+    }
+    rbtree.insert_batch(batch.begin(), batch.end());
+    REQUIRE(rbtree.size() == map.size());
+    REQUIRE(rbtree.height() <= 2 * std::log2(rbtree.size() + 1));
+    for (const auto & element : map) {
+      REQUIRE(rbtree.search(element.first)->value == element.second);
+    }
+  };
+  SECTION("Test a batch larger than the tree") {
+    insert_batch(1000);
+    insert_batch(5000);
+  }
+  SECTION("Test a batch smaller than the tree") {
+    insert_batch(5000);
+    insert_batch(100);
+    insert_batch(1000);
+  }
+  SECTION("Test an empty batch") {
+    insert_batch(0);
+    insert_batch(100);
+    insert_batch(0);
+  }
+}
+
 SCENARIO("Test Red Black Tree") {
   GIVEN("A Red Black Tree") {
     forest::rbtree <int, int> rbtree;
@@ -73,6 +660,26 @@ SCENARIO("Test Red Black Tree") {
       THEN("Call post_order_traversal") {
         rbtree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(rbtree.rank(42) == 0);
+      }
+      THEN("Test select") {
+        REQUIRE(rbtree.select(0) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(rbtree.count_range(0, 100) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(rbtree.percentile(50) == nullptr);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        REQUIRE(rbtree.sample(generator) == nullptr);
+      }
+      THEN("Test iterators") {
+        REQUIRE(rbtree.begin() == rbtree.end());
+        REQUIRE(rbtree.rbegin() == rbtree.rend());
+      }
     }
     WHEN("Nodes are inserted in random order") {
       rbtree.insert(4 , 0);
@@ -142,6 +749,125 @@ SCENARIO("Test Red Black Tree") {
       THEN("Call post_order_traversal") {
         rbtree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(rbtree.rank(0) == 0);
+        REQUIRE(rbtree.rank(3) == 2);
+        REQUIRE(rbtree.rank(5) == 4);
+        REQUIRE(rbtree.rank(1337) == 7);
+      }
+      THEN("Test select") {
+        REQUIRE(rbtree.select(0)->key == 0);
+        REQUIRE(rbtree.select(3)->key == 4);
+        REQUIRE(rbtree.select(6)->key == 90);
+        REQUIRE(rbtree.select(7) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(rbtree.count_range(2, 14) == 3);
+        REQUIRE(rbtree.count_range(1, 100) == 6);
+        REQUIRE(rbtree.count_range(14, 2) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(rbtree.percentile(0)->key == 0);
+        REQUIRE(rbtree.percentile(50)->key == 4);
+        REQUIRE(rbtree.percentile(99)->key == 90);
+        REQUIRE(rbtree.percentile(100)->key == 90);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        for (int i = 0; i < 100; i++) {
+          auto result = rbtree.sample(generator);
+          REQUIRE(result != nullptr);
+          REQUIRE(rbtree.search(result->key) == result);
+        }
+      }
+      THEN("Test erase for a node that does not exist") {
+        REQUIRE(rbtree.erase(1337) == 0);
+        REQUIRE(rbtree.size() == 7);
+      }
+      THEN("Test erase for a node that does exist") {
+        REQUIRE(rbtree.erase(4) == 1);
+        REQUIRE(rbtree.search(4) == nullptr);
+        REQUIRE(rbtree.size() == 6);
+        REQUIRE(rbtree.select(2)->key == 3);
+        REQUIRE(rbtree.select(3)->key == 14);
+        REQUIRE(rbtree.erase(0) == 1);
+        REQUIRE(rbtree.erase(90) == 1);
+        REQUIRE(rbtree.minimum()->key == 2);
+        REQUIRE(rbtree.maximum()->key == 45);
+        REQUIRE(rbtree.size() == 4);
+      }
+      THEN("Test erase recycles nodes") {
+        auto node = rbtree.search(14);
+        rbtree.erase(14);
+        rbtree.insert(15, 0);
+        REQUIRE(rbtree.search(15) == node);
+      }
+      THEN("Test iterators") {
+        std::vector <int> keys;
+        for (auto & node : rbtree) {
+          keys.push_back(node.key);
+        }
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        REQUIRE(std::distance(rbtree.begin(), rbtree.end()) == 7);
+        REQUIRE((--rbtree.end())->key == 90);
+        REQUIRE(std::prev(rbtree.end(), 7) == rbtree.begin());
+      }
+      THEN("Test reverse iterators") {
+        std::vector <int> keys;
+        for (auto it = rbtree.rbegin(); it != rbtree.rend(); ++it) {
+          keys.push_back(it->key);
+        }
+        REQUIRE(keys == std::vector <int> {90, 45, 14, 4, 3, 2, 0});
+      }
+      THEN("Test iterators with algorithms") {
+        auto it = std::find_if(rbtree.begin(), rbtree.end(), [](const auto & node) { return node.key > 10; });
+        REQUIRE(it != rbtree.end());
+        REQUIRE(it->key == 14);
+        REQUIRE(std::count_if(rbtree.begin(), rbtree.end(), [](const auto & node) { return node.key % 2 == 0; }) == 5);
+      }
+      THEN("Call traversals with a capturing handler") {
+        std::vector <int> keys;
+        rbtree.in_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        keys.clear();
+        rbtree.pre_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == rbtree.root()->key);
+        keys.clear();
+        rbtree.post_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.back() == rbtree.root()->key);
+        keys.clear();
+        rbtree.breadth_first_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == rbtree.root()->key);
+      }
+      THEN("Call traversals with a handler that stops early") {
+        std::vector <int> keys;
+        auto handler = [&keys](const int & key, const int & value) {
+          keys.push_back(key);
+          return keys.size() < 3;
+        };
+        rbtree.in_order_traversal(handler);
+        REQUIRE(keys == std::vector <int> {0, 2, 3});
+        keys.clear();
+        rbtree.pre_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        rbtree.post_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        rbtree.breadth_first_traversal(handler);
+        REQUIRE(keys.size() == 3);
+      }
+      THEN("Test clear") {
+        rbtree.clear();
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.size() == 0);
+        REQUIRE(rbtree.root() == nullptr);
+        rbtree.insert(1, 1);
+        REQUIRE(rbtree.size() == 1);
+      }
     }
     WHEN("Nodes are inserted in ascending order") {
       for (int i = 0; i < 10; i++) {
@@ -207,6 +933,12 @@ SCENARIO("Test Red Black Tree") {
       THEN("Call post_order_traversal") {
         rbtree.post_order_traversal(handler);
       }
+      THEN("Test rank and select") {
+        for (int i = 0; i < 10; i++) {
+          REQUIRE(rbtree.rank(i) == static_cast<size_t>(i));
+          REQUIRE(rbtree.select(i)->key == i);
+        }
+      }
     }
     WHEN("Nodes are inserted in descending order") {
       for (int i = 9; i >= 0; i--) {
@@ -273,5 +1005,46 @@ SCENARIO("Test Red Black Tree") {
         rbtree.post_order_traversal(handler);
       }
     }
+    WHEN("Nodes are inserted and erased in random order") {
+      std::map <int, int> map;
+      std::mt19937 generator;
+      std::uniform_int_distribution <int> distribution(0, 999);
+      for (int i = 0; i < 20000; i++) {
+        int key {distribution(generator)};
+        if (i % 3 == 0) {
+          REQUIRE(rbtree.erase(key) == map.erase(key));
+        } else {
+          rbtree.insert(key, i);
+          map[key] = i;
+        }
+      }
+      THEN("Test size") {
+        REQUIRE(rbtree.size() == map.size());
+      }
+      THEN("Test height") {
+        REQUIRE(rbtree.height() <= 2 * std::log2(rbtree.size() + 1));
+        REQUIRE(rbtree.height() <= rbtree.size());
+      }
+      THEN("Test contents") {
+        size_t index {0};
+        for (auto element : map) {
+          auto node = rbtree.select(index++);
+          REQUIRE(node->key == element.first);
+          REQUIRE(node->value == element.second);
+        }
+      }
+      THEN("Test erase until empty") {
+        for (auto element : map) {
+          REQUIRE(rbtree.erase(element.first) == 1);
+        }
+        REQUIRE(rbtree.empty() == true);
+        REQUIRE(rbtree.size() == 0);
+      }
+      THEN("Test iterators") {
+        REQUIRE(std::equal(rbtree.begin(), rbtree.end(), map.begin(), map.end(), [](const auto & node, const auto & element) {
+          return node.key == element.first && node.value == element.second;
+        }));
+      }
+    }
   }
 }
@@ -4,10 +4,85 @@
  */
 
 #include <catch2/catch.hpp>
+#include <forest/avltree.hpp>
 #include <forest/splaytree.hpp>
+#include <forest/thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
-auto handler = [](const int & key, const int & value) {};
+namespace {
+  class less_only {
+  public:
+    explicit less_only(int VALUE) : value(VALUE) {
+
+    }
+    bool operator<(const less_only & other) const {
+      return value < other.value;
+    }
+    int value;
+  };
+
+  class counting_less {
+  public:
+    explicit counting_less(size_t * COUNT) : count(COUNT) {
+
+    }
+    bool operator()(int lhs, int rhs) const {
+      (*count)++;
+      return lhs < rhs;
+    }
+    size_t * count;
+  };
+
+  int copies {0};
+
+  class copy_counter {
+  public:
+    copy_counter() = default;
+    copy_counter(const copy_counter &) {
+      copies++;
+    }
+    copy_counter(copy_counter &&) = default;
+    copy_counter& operator=(const copy_counter &) {
+      copies++;
+      return *this;
+    }
+    copy_counter& operator=(copy_counter &&) = default;
+  };
+
+  int live_nodes {0};
+
+  template <typename V>
+  class counting_allocator : public std::allocator <V> {
+  public:
+    template <typename W>
+    struct rebind {
+      using other = counting_allocator <W>;
+    };
+    counting_allocator() = default;
+    template <typename W>
+    counting_allocator(const counting_allocator <W> &) noexcept {
+
+    }
+    V * allocate(size_t n) {
+      live_nodes += static_cast<int>(n);
+      return std::allocator <V>::allocate(n);
+    }
+    void deallocate(V * storage, size_t n) {
+      live_nodes -= static_cast<int>(n);
+      std::allocator <V>::deallocate(storage, n);
+    }
+  };
+}
+
+static auto handler = [](const int & key, const int & value) {};
 
 TEST_CASE("Test Splay Tree Constructor") {
   forest::splaytree <int, std::string> splaytree({
@@ -28,6 +103,485 @@ TEST_CASE("Test Splay Tree Constructor") {
   REQUIRE(splaytree.search(45)->value == "Heimdall");
 }
 
+TEST_CASE("Test Splay Tree Allocator") {
+  {
+    forest::splaytree <int, std::string, std::less <int>, counting_allocator <std::pair <const int, std::string> > > splaytree;
+    for (int i = 0; i < 100; i++) {
+      splaytree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 0; i < 50; i++) {
+      splaytree.erase(i);
+    }
+    REQUIRE(live_nodes == 100);
+    for (int i = 100; i < 150; i++) {
+      splaytree.insert(i, std::to_string(i));
+    }
+    REQUIRE(live_nodes == 100);
+  }
+  REQUIRE(live_nodes == 0);
+}
+
+TEST_CASE("Test Splay Tree Comparator") {
+  SECTION("Test a reversed order") {
+    forest::splaytree <int, int, std::greater <int> > splaytree({{1, 1}, {2, 2}, {3, 3}, {4, 4}});
+    std::vector <int> keys;
+    for (auto & node : splaytree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {4, 3, 2, 1});
+    REQUIRE(splaytree.minimum()->key == 4);
+    REQUIRE(splaytree.search(3)->value == 3);
+    REQUIRE(splaytree.rank(2) == 2);
+  }
+  SECTION("Test keys that only define operator<") {
+    forest::splaytree <less_only, int> splaytree;
+    splaytree.insert(less_only(2), 2);
+    splaytree.insert(less_only(1), 1);
+    splaytree.insert(less_only(2), 3);
+    REQUIRE(splaytree.size() == 2);
+    REQUIRE(splaytree.search(less_only(2))->value == 3);
+    REQUIRE(splaytree.search(less_only(5)) == nullptr);
+    REQUIRE(splaytree.erase(less_only(1)) == 1);
+  }
+  SECTION("Test one comparison per level") {
+    size_t count {0};
+    forest::splaytree <int, int, counting_less> splaytree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      splaytree.insert((i * 7919) % 1000, i);
+    }
+    for (int i = 0; i < 1000; i++) {
+      count = 0;
+      REQUIRE(splaytree.search(i) != nullptr);
+      REQUIRE(count <= splaytree.height() + 1);
+    }
+  }
+}
+
+TEST_CASE("Test Splay Tree Move Semantics") {
+  SECTION("Test move-only values") {
+    forest::splaytree <int, std::unique_ptr <int> > splaytree;
+    REQUIRE(splaytree.insert(1, std::unique_ptr <int>(new int(1))).second == true);
+    REQUIRE(splaytree.insert(1, std::unique_ptr <int>(new int(2))).second == false);
+    REQUIRE(*splaytree.search(1)->value == 2);
+    REQUIRE(splaytree.try_emplace(2, new int(3)).second == true);
+    REQUIRE(*splaytree.search(2)->value == 3);
+  }
+  SECTION("Test try_emplace leaves its arguments alone when the key exists") {
+    forest::splaytree <int, std::unique_ptr <int> > splaytree;
+    splaytree.try_emplace(1, new int(1));
+    std::unique_ptr <int> value(new int(2));
+    auto result = splaytree.try_emplace(1, std::move(value));
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->key == 1);
+    REQUIRE(value != nullptr);
+    REQUIRE(*splaytree.search(1)->value == 1);
+  }
+  SECTION("Test insert_or_assign") {
+    forest::splaytree <int, std::string> splaytree;
+    REQUIRE(splaytree.insert_or_assign(1, "Thor").second == true);
+    auto result = splaytree.insert_or_assign(1, "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "Odin");
+    REQUIRE(splaytree.size() == 1);
+  }
+  SECTION("Test emplace") {
+    forest::splaytree <std::string, std::string> splaytree;
+    REQUIRE(splaytree.emplace("Thor", 3, 'a').second == true);
+    REQUIRE(splaytree.search("Thor")->value == "aaa");
+    auto result = splaytree.emplace("Thor", "Odin");
+    REQUIRE(result.second == false);
+    REQUIRE(result.first->value == "aaa");
+    REQUIRE(splaytree.size() == 1);
+  }
+  SECTION("Test move construction") {
+    forest::splaytree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    auto root = source.root();
+    forest::splaytree <int, int> splaytree(std::move(source));
+    REQUIRE(splaytree.root() == root);
+    REQUIRE(splaytree.size() == 3);
+    REQUIRE(source.empty() == true);
+    source.insert(4, 4);
+    REQUIRE(source.size() == 1);
+  }
+  SECTION("Test move assignment") {
+    forest::splaytree <int, int> source({{1, 1}, {2, 2}, {3, 3}});
+    forest::splaytree <int, int> splaytree({{4, 4}});
+    splaytree = std::move(source);
+    REQUIRE(splaytree.size() == 3);
+    REQUIRE(splaytree.search(4) == nullptr);
+    REQUIRE(splaytree.search(2)->value == 2);
+    REQUIRE(source.empty() == true);
+  }
+  SECTION("Test swap") {
+    forest::splaytree <int, int> first({{1, 1}, {2, 2}, {3, 3}});
+    forest::splaytree <int, int> second({{4, 4}});
+    swap(first, second);
+    REQUIRE(first.size() == 1);
+    REQUIRE(first.search(4) != nullptr);
+    REQUIRE(second.size() == 3);
+    REQUIRE(second.search(1) != nullptr);
+  }
+  SECTION("Test trees in a vector") {
+    std::vector <forest::splaytree <int, int> > trees;
+    for (int i = 0; i < 10; i++) {
+      trees.emplace_back();
+      trees.back().insert(i, i);
+    }
+    for (int i = 0; i < 10; i++) {
+      REQUIRE(trees[i].search(i) != nullptr);
+      REQUIRE(trees[i].size() == 1);
+    }
+  }
+  SECTION("Test rvalues are not copied") {
+    forest::splaytree <int, copy_counter> splaytree;
+    copies = 0;
+    for (int i = 0; i < 10; i++) {
+      splaytree.insert(i, copy_counter());
+      splaytree.insert_or_assign(i, copy_counter());
+      splaytree.try_emplace(i + 10);
+    }
+    REQUIRE(copies == 0);
+    REQUIRE(splaytree.size() == 20);
+  }
+}
+
+TEST_CASE("Test Splay Tree Bulk Construction") {
+  SECTION("Test a sorted range") {
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 1000; i++) {
+      elements.emplace_back(i, i * 2);
+    }
+    forest::splaytree <int, int> splaytree(elements.begin(), elements.end());
+    REQUIRE(splaytree.size() == 1000);
+    REQUIRE(splaytree.height() == 10);
+    REQUIRE(splaytree.root()->key == 500);
+    for (int i = 0; i < 1000; i++) {
+      REQUIRE(splaytree.search(i)->value == i * 2);
+      REQUIRE(splaytree.select(i)->key == i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+      REQUIRE(splaytree.erase(i) == 1);
+    }
+    for (int i = 1000; i < 1100; i++) {
+      splaytree.insert(i, i);
+    }
+    REQUIRE(splaytree.size() == 600);
+    REQUIRE(splaytree.rank(1000) == 500);
+  }
+  SECTION("Test an unsorted range with duplicate keys") {
+    std::vector <std::pair <int, std::string> > elements {{3, "Baldr"}, {1, "Thor"}, {3, "Frigg"}, {2, "Odin"}, {1, "Loki"}};
+    forest::splaytree <int, std::string> splaytree(elements.begin(), elements.end());
+    REQUIRE(splaytree.size() == 3);
+    REQUIRE(splaytree.search(1)->value == "Loki");
+    REQUIRE(splaytree.search(2)->value == "Odin");
+    REQUIRE(splaytree.search(3)->value == "Frigg");
+  }
+  SECTION("Test a parallel build from an unsorted range") {
+    forest::thread_pool pool(2);
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 50000; i++) {
+      elements.emplace_back((i * 7919) % 40000, i);
+    }
+    forest::splaytree <int, int> splaytree(elements.begin(), elements.end(), pool);
+    REQUIRE(splaytree.size() == 40000);
+    for (int i = 0; i < 40000; i++) {
+      REQUIRE(splaytree.select(i)->key == i);
+    }
+    for (int i = 10000; i < 50000; i++) {
+      REQUIRE(splaytree.search((i * 7919) % 40000)->value == i);
+    }
+    splaytree.assign(elements.begin(), elements.begin() + 100, pool);
+    REQUIRE(splaytree.size() == 100);
+    REQUIRE(splaytree.search(0)->value == 0);
+  }
+  SECTION("Test assign replaces the contents") {
+    forest::splaytree <int, int> splaytree({{1, 1}, {2, 2}, {3, 3}});
+    std::vector <std::pair <int, int> > elements {{4, 4}, {5, 5}};
+    splaytree.assign(elements.begin(), elements.end());
+    REQUIRE(splaytree.size() == 2);
+    REQUIRE(splaytree.search(1) == nullptr);
+    REQUIRE(splaytree.minimum()->key == 4);
+    splaytree.assign(elements.end(), elements.end());
+    REQUIRE(splaytree.empty() == true);
+  }
+  SECTION("Test converting from another tree") {
+    forest::avltree <int, std::string> source({{2, "Thor"}, {4, "Odin"}, {90, "Loki"}, {3, "Baldr"}});
+    forest::splaytree <int, std::string> splaytree(source.begin(), source.end());
+    REQUIRE(splaytree.size() == 4);
+    REQUIRE(splaytree.search(90)->value == "Loki");
+    REQUIRE(splaytree.minimum()->key == 2);
+    REQUIRE(splaytree.maximum()->key == 90);
+  }
+}
+
+TEST_CASE("Test Splay Tree Parallel Traversal") {
+  forest::thread_pool pool(2);
+  forest::splaytree <int, int> splaytree;
+  REQUIRE(splaytree.parallel_reduce(0L, [](const int & key, const int &) {
+    return static_cast<long>(key);
+  }, std::plus <long>(), pool) == 0);
+  for (int i = 0; i < 20000; i++) {
+    splaytree.insert((i * 7919) % 20000, i % 10);
+  }
+  SECTION("Test parallel_for_each visits every node") {
+    std::atomic <long> sum {0};
+    splaytree.parallel_for_each([&](const int & key, const int &) {
+      sum += key;
+    }, pool);
+    REQUIRE(sum == 199990000L);
+  }
+  SECTION("Test parallel_reduce combines in key order") {
+    std::string expected;
+    splaytree.in_order_traversal([&](const int &, const int & value) {
+      expected += std::to_string(value);
+    });
+    std::string digits {splaytree.parallel_reduce(std::string(), [](const int &, const int & value) {
+      return std::to_string(value);
+    }, [](std::string lhs, const std::string & rhs) {
+      return lhs += rhs;
+    }, pool)};
+    REQUIRE(digits == expected);
+  }
+}
+
+TEST_CASE("Test Splay Tree Bounds") {
+  forest::splaytree <int, int> splaytree;
+  std::map <int, int> map;
+  for (int i = 0; i < 200; i += 3) {
+    splaytree.insert(i, i);
+    map[i] = i;
+  }
+  SECTION("Test lower_bound, upper_bound and equal_range") {
+    for (int i = -5; i < 210; i++) {
+      auto lower = splaytree.lower_bound(i);
+      auto upper = splaytree.upper_bound(i);
+      auto range = splaytree.equal_range(i);
+      REQUIRE((lower == splaytree.end()) == (map.lower_bound(i) == map.end()));
+      REQUIRE((upper == splaytree.end()) == (map.upper_bound(i) == map.end()));
+      if (lower != splaytree.end()) REQUIRE(lower->key == map.lower_bound(i)->first);
+      if (upper != splaytree.end()) REQUIRE(upper->key == map.upper_bound(i)->first);
+      REQUIRE(range.first == lower);
+      REQUIRE(range.second == upper);
+      REQUIRE(std::distance(range.first, range.second) == static_cast<std::ptrdiff_t>(map.count(i)));
+    }
+  }
+  SECTION("Test floor and ceiling") {
+    REQUIRE(splaytree.floor(-1) == nullptr);
+    REQUIRE(splaytree.floor(0)->key == 0);
+    REQUIRE(splaytree.floor(5)->key == 3);
+    REQUIRE(splaytree.floor(1000)->key == 198);
+    REQUIRE(splaytree.ceiling(-1)->key == 0);
+    REQUIRE(splaytree.ceiling(4)->key == 6);
+    REQUIRE(splaytree.ceiling(6)->key == 6);
+    REQUIRE(splaytree.ceiling(199) == nullptr);
+  }
+  SECTION("Test for_each_in_range") {
+    std::vector <int> keys;
+    splaytree.for_each_in_range(10, 22, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys == std::vector <int> {12, 15, 18, 21});
+    keys.clear();
+    splaytree.for_each_in_range(12, 12, [&](const int & key, const int & value) {
+      keys.push_back(key);
+    });
+    REQUIRE(keys.empty() == true);
+    splaytree.for_each_in_range(0, 1000, [&](const int & key, const int & value) {
+      keys.push_back(key);
+      return keys.size() < 3;
+    });
+    REQUIRE(keys == std::vector <int> {0, 3, 6});
+  }
+}
+
+TEST_CASE("Test Splay Tree Hinted Insert") {
+  SECTION("Test appends cost one comparison") {
+    size_t count {0};
+    forest::splaytree <int, int, counting_less> splaytree((counting_less(&count)));
+    for (int i = 0; i < 1000; i++) {
+      splaytree.insert(i, i);
+    }
+    REQUIRE(count < 1000);
+    REQUIRE(splaytree.size() == 1000);
+    REQUIRE(splaytree.maximum()->key == 999);
+    REQUIRE(splaytree.erase(999) == 1);
+    REQUIRE(splaytree.maximum()->key == 998);
+    splaytree.insert(500, 0);
+    REQUIRE(splaytree.maximum()->key == 998);
+    REQUIRE(splaytree.search(500)->value == 0);
+  }
+  SECTION("Test a correct hint") {
+    size_t count {0};
+    forest::splaytree <int, int, counting_less> splaytree((counting_less(&count)));
+    for (int i = 0; i < 1000; i += 2) {
+      splaytree.insert(i, i);
+    }
+    for (int i = 1; i < 1000; i += 2) {
+      auto hint = splaytree.search(i + 1);
+      count = 0;
+      auto result = splaytree.insert(hint, i, i);
+      REQUIRE(count <= 3);
+      REQUIRE(result->key == i);
+    }
+    REQUIRE(splaytree.size() == 1000);
+    int expected {0};
+    for (auto & node : splaytree) {
+      REQUIRE(node.key == expected++);
+    }
+  }
+  SECTION("Test a wrong hint") {
+    forest::splaytree <int, int> splaytree({{1, 1}, {5, 5}, {9, 9}});
+    REQUIRE(splaytree.insert(splaytree.begin(), 7, 7)->key == 7);
+    REQUIRE(splaytree.insert(splaytree.end(), 3, 3)->key == 3);
+    REQUIRE(splaytree.insert(splaytree.end(), 10, 10)->key == 10);
+    REQUIRE(splaytree.insert(splaytree.search(9), 9, 0)->value == 0);
+    REQUIRE(splaytree.size() == 6);
+    std::vector <int> keys;
+    for (auto & node : splaytree) {
+      keys.push_back(node.key);
+    }
+    REQUIRE(keys == std::vector <int> {1, 3, 5, 7, 9, 10});
+    REQUIRE((--splaytree.end())->key == 10);
+  }
+}
+
+TEST_CASE("Test Splay Tree Batch Insert") {
+  std::mt19937 generator(7);
+  std::uniform_int_distribution <int> distribution(0, 99999);
+  forest::splaytree <int, int> splaytree;
+  std::map <int, int> map;
+  auto insert_batch = [&](size_t count) {
+    std::vector <std::pair <int, int> > batch;
+    for (size_t i = 0; i < count; i++) {
+      batch.emplace_back(distribution(generator), distribution(generator));
+      map[batch.back().first] = batch.back().second;
+    }
+    splaytree.insert_batch(batch.begin(), batch.end());
+    REQUIRE(splaytree.size() == map.size());
+    for (const auto & element : map) {
+      REQUIRE(splaytree.search(element.first)->value == element.second);
+    }
+  };
+  SECTION("Test a batch larger than the tree") {
+    insert_batch(1000);
+    insert_batch(5000);
+  }
+  SECTION("Test a batch smaller than the tree") {
+    insert_batch(5000);
+    insert_batch(100);
+    insert_batch(1000);
+  }
+  SECTION("Test a batch follows the finger instead of splaying every key") {
+    size_t count {0};
+    std::vector <std::pair <int, int> > elements;
+    for (int i = 0; i < 20000; i += 2) {
+      elements.emplace_back(i, i);
+    }
+    forest::splaytree <int, int, counting_less> counted(elements.begin(), elements.end(), counting_less(&count));
+    std::vector <std::pair <int, int> > batch;
+    for (int i = 5001; i < 7000; i += 2) {
+      batch.emplace_back(i, i);
+    }
+    count = 0;
+    counted.insert_batch(batch.begin(), batch.end());
+    REQUIRE(count <= 10 * batch.size());
+    REQUIRE(counted.size() == 11000);
+    REQUIRE(counted.root()->key == 6999);
+    for (int i = 5000; i < 7000; i++) {
+      REQUIRE(counted.search(i)->value == i);
+    }
+  }
+  SECTION("Test an empty batch") {
+    insert_batch(0);
+    insert_batch(100);
+    insert_batch(0);
+  }
+}
+
+TEST_CASE("Test Splay Tree Splay Policies") {
+  auto chain = [](auto & splaytree) {
+    for (int i = 0; i < 1000; i++) {
+      splaytree.insert(i, i);
+    }
+    REQUIRE(splaytree.height() == 1000);
+    REQUIRE(splaytree.root()->key == 999);
+  };
+  auto matches = [](auto & splaytree, const std::map <int, int> & map) {
+    std::mt19937 generator(3);
+    for (int i = 0; i < 20000; i++) {
+      int key {static_cast<int>(generator() % 2000)};
+      auto n = splaytree.search(key);
+      auto element = map.find(key);
+      REQUIRE((n != nullptr) == (element != map.end()));
+      if (n) REQUIRE(n->value == element->second);
+    }
+    REQUIRE(splaytree.size() == map.size());
+    auto element = map.begin();
+    for (auto & node : splaytree) {
+      REQUIRE(node.key == element->first);
+      ++element;
+    }
+  };
+  std::map <int, int> map;
+  for (int i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+  SECTION("Test full splay moves every hit to the root") {
+    forest::splaytree <int, int> splaytree;
+    chain(splaytree);
+    REQUIRE(splaytree.search(0)->key == 0);
+    REQUIRE(splaytree.root()->key == 0);
+    REQUIRE(splaytree.height() <= 502);
+    matches(splaytree, map);
+  }
+  SECTION("Test semi splay shortens the access path") {
+    forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::semi_splay> splaytree;
+    chain(splaytree);
+    REQUIRE(splaytree.search(0)->key == 0);
+    REQUIRE(splaytree.height() <= 502);
+    matches(splaytree, map);
+  }
+  SECTION("Test probabilistic splay") {
+    forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::probabilistic_splay> never(forest::probabilistic_splay(0.0));
+    chain(never);
+    REQUIRE(never.search(0)->key == 0);
+    REQUIRE(never.root()->key == 999);
+    REQUIRE(never.height() == 1000);
+    forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::probabilistic_splay> always(forest::probabilistic_splay(1.0));
+    chain(always);
+    REQUIRE(always.search(0)->key == 0);
+    REQUIRE(always.root()->key == 0);
+    forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::probabilistic_splay> sometimes(forest::probabilistic_splay(0.25, 11));
+    chain(sometimes);
+    matches(sometimes, map);
+  }
+  SECTION("Test depth threshold splay ignores shallow hits") {
+    forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::depth_threshold_splay> splaytree(forest::depth_threshold_splay(8));
+    chain(splaytree);
+    REQUIRE(splaytree.search(992)->key == 992);
+    REQUIRE(splaytree.root()->key == 999);
+    REQUIRE(splaytree.search(990)->key == 990);
+    REQUIRE(splaytree.root()->key == 990);
+    matches(splaytree, map);
+  }
+  SECTION("Test the data constructors take a policy") {
+    using never_splaytree = forest::splaytree <int, int, std::less <int>, std::allocator <std::pair <const int, int> >, forest::probabilistic_splay>;
+    std::vector <std::pair <int, int> > elements(map.begin(), map.end());
+    forest::thread_pool pool(2);
+    never_splaytree ranged(elements.begin(), elements.end(), std::less <int>(), std::allocator <std::pair <const int, int> >(), forest::probabilistic_splay(0.0));
+    never_splaytree pooled(elements.begin(), elements.end(), pool, std::less <int>(), std::allocator <std::pair <const int, int> >(), forest::probabilistic_splay(0.0));
+    never_splaytree listed({{1, 1}, {2, 2}, {3, 3}}, std::less <int>(), std::allocator <std::pair <const int, int> >(), forest::probabilistic_splay(0.0));
+    for (never_splaytree * splaytree : {&ranged, &pooled, &listed}) {
+      const int root {splaytree->root()->key};
+      REQUIRE(splaytree->search(1)->key == 1);
+      REQUIRE(splaytree->root()->key == root);
+    }
+    matches(ranged, map);
+    matches(pooled, map);
+  }
+}
+
 SCENARIO("Test Splay Tree") {
   GIVEN("A Splay Tree") {
     forest::splaytree <int, int> splaytree;
@@ -73,6 +627,26 @@ SCENARIO("Test Splay Tree") {
       THEN("Call post_order_traversal") {
         splaytree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(splaytree.rank(42) == 0);
+      }
+      THEN("Test select") {
+        REQUIRE(splaytree.select(0) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(splaytree.count_range(0, 100) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(splaytree.percentile(50) == nullptr);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        REQUIRE(splaytree.sample(generator) == nullptr);
+      }
+      THEN("Test iterators") {
+        REQUIRE(splaytree.begin() == splaytree.end());
+        REQUIRE(splaytree.rbegin() == splaytree.rend());
+      }
     }
     WHEN("Nodes are inserted in random order") {
       splaytree.insert(4 , 0);
@@ -142,6 +716,125 @@ SCENARIO("Test Splay Tree") {
       THEN("Call post_order_traversal") {
         splaytree.post_order_traversal(handler);
       }
+      THEN("Test rank") {
+        REQUIRE(splaytree.rank(0) == 0);
+        REQUIRE(splaytree.rank(3) == 2);
+        REQUIRE(splaytree.rank(5) == 4);
+        REQUIRE(splaytree.rank(1337) == 7);
+      }
+      THEN("Test select") {
+        REQUIRE(splaytree.select(0)->key == 0);
+        REQUIRE(splaytree.select(3)->key == 4);
+        REQUIRE(splaytree.select(6)->key == 90);
+        REQUIRE(splaytree.select(7) == nullptr);
+      }
+      THEN("Test count_range") {
+        REQUIRE(splaytree.count_range(2, 14) == 3);
+        REQUIRE(splaytree.count_range(1, 100) == 6);
+        REQUIRE(splaytree.count_range(14, 2) == 0);
+      }
+      THEN("Test percentile") {
+        REQUIRE(splaytree.percentile(0)->key == 0);
+        REQUIRE(splaytree.percentile(50)->key == 4);
+        REQUIRE(splaytree.percentile(99)->key == 90);
+        REQUIRE(splaytree.percentile(100)->key == 90);
+      }
+      THEN("Test sample") {
+        std::mt19937 generator;
+        for (int i = 0; i < 100; i++) {
+          auto result = splaytree.sample(generator);
+          REQUIRE(result != nullptr);
+          REQUIRE(splaytree.search(result->key) == result);
+        }
+      }
+      THEN("Test erase for a node that does not exist") {
+        REQUIRE(splaytree.erase(1337) == 0);
+        REQUIRE(splaytree.size() == 7);
+      }
+      THEN("Test erase for a node that does exist") {
+        REQUIRE(splaytree.erase(4) == 1);
+        REQUIRE(splaytree.search(4) == nullptr);
+        REQUIRE(splaytree.size() == 6);
+        REQUIRE(splaytree.select(2)->key == 3);
+        REQUIRE(splaytree.select(3)->key == 14);
+        REQUIRE(splaytree.erase(0) == 1);
+        REQUIRE(splaytree.erase(90) == 1);
+        REQUIRE(splaytree.minimum()->key == 2);
+        REQUIRE(splaytree.maximum()->key == 45);
+        REQUIRE(splaytree.size() == 4);
+      }
+      THEN("Test erase recycles nodes") {
+        auto node = splaytree.search(14);
+        splaytree.erase(14);
+        splaytree.insert(15, 0);
+        REQUIRE(splaytree.search(15) == node);
+      }
+      THEN("Test iterators") {
+        std::vector <int> keys;
+        for (auto & node : splaytree) {
+          keys.push_back(node.key);
+        }
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        REQUIRE(std::distance(splaytree.begin(), splaytree.end()) == 7);
+        REQUIRE((--splaytree.end())->key == 90);
+        REQUIRE(std::prev(splaytree.end(), 7) == splaytree.begin());
+      }
+      THEN("Test reverse iterators") {
+        std::vector <int> keys;
+        for (auto it = splaytree.rbegin(); it != splaytree.rend(); ++it) {
+          keys.push_back(it->key);
+        }
+        REQUIRE(keys == std::vector <int> {90, 45, 14, 4, 3, 2, 0});
+      }
+      THEN("Test iterators with algorithms") {
+        auto it = std::find_if(splaytree.begin(), splaytree.end(), [](const auto & node) { return node.key > 10; });
+        REQUIRE(it != splaytree.end());
+        REQUIRE(it->key == 14);
+        REQUIRE(std::count_if(splaytree.begin(), splaytree.end(), [](const auto & node) { return node.key % 2 == 0; }) == 5);
+      }
+      THEN("Call traversals with a capturing handler") {
+        std::vector <int> keys;
+        splaytree.in_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys == std::vector <int> {0, 2, 3, 4, 14, 45, 90});
+        keys.clear();
+        splaytree.pre_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == splaytree.root()->key);
+        keys.clear();
+        splaytree.post_order_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.back() == splaytree.root()->key);
+        keys.clear();
+        splaytree.breadth_first_traversal([&keys](const int & key, const int & value) { keys.push_back(key); });
+        REQUIRE(keys.size() == 7);
+        REQUIRE(keys.front() == splaytree.root()->key);
+      }
+      THEN("Call traversals with a handler that stops early") {
+        std::vector <int> keys;
+        auto handler = [&keys](const int & key, const int & value) {
+          keys.push_back(key);
+          return keys.size() < 3;
+        };
+        splaytree.in_order_traversal(handler);
+        REQUIRE(keys == std::vector <int> {0, 2, 3});
+        keys.clear();
+        splaytree.pre_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        splaytree.post_order_traversal(handler);
+        REQUIRE(keys.size() == 3);
+        keys.clear();
+        splaytree.breadth_first_traversal(handler);
+        REQUIRE(keys.size() == 3);
+      }
+      THEN("Test clear") {
+        splaytree.clear();
+        REQUIRE(splaytree.empty() == true);
+        REQUIRE(splaytree.size() == 0);
+        REQUIRE(splaytree.root() == nullptr);
+        splaytree.insert(1, 1);
+        REQUIRE(splaytree.size() == 1);
+      }
     }
     WHEN("Nodes are inserted in ascending order") {
       for (int i = 0; i < 10; i++) {
@@ -207,6 +900,12 @@ SCENARIO("Test Splay Tree") {
       THEN("Call post_order_traversal") {
         splaytree.post_order_traversal(handler);
       }
+      THEN("Test rank and select") {
+        for (int i = 0; i < 10; i++) {
+          REQUIRE(splaytree.rank(i) == static_cast<size_t>(i));
+          REQUIRE(splaytree.select(i)->key == i);
+        }
+      }
     }
     WHEN("Nodes are inserted in descending order") {
       for (int i = 9; i >= 0; i--) {
@@ -273,5 +972,66 @@ SCENARIO("Test Splay Tree") {
         splaytree.post_order_traversal(handler);
       }
     }
+    WHEN("Nodes are inserted and erased in random order") {
+      std::map <int, int> map;
+      std::mt19937 generator;
+      std::uniform_int_distribution <int> distribution(0, 999);
+      for (int i = 0; i < 20000; i++) {
+        int key {distribution(generator)};
+        if (i % 3 == 0) {
+          REQUIRE(splaytree.erase(key) == map.erase(key));
+        } else {
+          splaytree.insert(key, i);
+          map[key] = i;
+        }
+      }
+      THEN("Test size") {
+        REQUIRE(splaytree.size() == map.size());
+      }
+      THEN("Test height") {
+        REQUIRE(splaytree.height() <= splaytree.size());
+      }
+      THEN("Test contents") {
+        size_t index {0};
+        for (auto element : map) {
+          auto node = splaytree.select(index++);
+          REQUIRE(node->key == element.first);
+          REQUIRE(node->value == element.second);
+        }
+      }
+      THEN("Test erase until empty") {
+        for (auto element : map) {
+          REQUIRE(splaytree.erase(element.first) == 1);
+        }
+        REQUIRE(splaytree.empty() == true);
+        REQUIRE(splaytree.size() == 0);
+      }
+      THEN("Test iterators") {
+        REQUIRE(std::equal(splaytree.begin(), splaytree.end(), map.begin(), map.end(), [](const auto & node, const auto & element) {
+          return node.key == element.first && node.value == element.second;
+        }));
+      }
+    }
+    WHEN("A large number of nodes are inserted in ascending order") {
+      const int n {1 << 20};
+      for (int i = 0; i < n; i++) {
+        splaytree.insert(i, i);
+      }
+      THEN("Test height") {
+        REQUIRE(splaytree.height() == n);
+      }
+      THEN("Call traversals") {
+        int count {0};
+        auto handler = [&count](const int & key, const int & value) { count++; };
+        splaytree.pre_order_traversal(handler);
+        splaytree.in_order_traversal(handler);
+        splaytree.post_order_traversal(handler);
+        REQUIRE(count == 3 * n);
+      }
+      THEN("Test clear") {
+        splaytree.clear();
+        REQUIRE(splaytree.empty() == true);
+      }
+    }
   }
 }
@@ -0,0 +1,82 @@
+/*
+ * @file static_index.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/rbtree.hpp>
+#include <forest/static_index.hpp>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <typename K>
+  bool matches(size_t size) {
+    std::mt19937 generator(static_cast<unsigned>(size));
+    std::vector <std::pair <K, int> > elements;
+    std::map <K, int> map;
+    for (size_t i = 0; i < size; i++) {
+      K key {static_cast<K>(static_cast<int>(generator() % (3 * size + 1)) - static_cast<int>(size))};
+      elements.emplace_back(key, static_cast<int>(i));
+      map[key] = static_cast<int>(i);
+    }
+    forest::rbtree <K, int> rbtree(elements.begin(), elements.end());
+    forest::static_index <K, int> index(rbtree.begin(), rbtree.end());
+    bool result {index.size() == map.size()};
+    auto element = map.begin();
+    index.in_order_traversal([&](const K & key, const int & value) {
+      result = result && element->first == key && element->second == value;
+      ++element;
+    });
+    for (int i = -static_cast<int>(size) - 2; i <= 2 * static_cast<int>(size) + 2; i++) {
+      K key {static_cast<K>(i)};
+      auto found = index.search(key);
+      auto expected = map.find(key);
+      result = result && (found == nullptr) == (expected == map.end());
+      if (found != nullptr) result = result && found->value == expected->second;
+      auto lower = index.lower_bound(key);
+      auto bound = map.lower_bound(key);
+      result = result && (lower == nullptr) == (bound == map.end());
+      if (lower != nullptr) result = result && lower->key == bound->first;
+    }
+    return result;
+  }
+}
+
+SCENARIO("Test Static Index") {
+  GIVEN("An empty Static Index") {
+    forest::static_index <int, int> index;
+    THEN("Test the queries") {
+      REQUIRE(index.empty() == true);
+      REQUIRE(index.search(1) == nullptr);
+      REQUIRE(index.lower_bound(1) == nullptr);
+      REQUIRE(index.minimum() == nullptr);
+      REQUIRE(index.maximum() == nullptr);
+    }
+  }
+  GIVEN("Static Indexes of every kernel") {
+    THEN("Test they match a map") {
+      for (size_t size : {1, 15, 16, 17, 272, 273, 5000}) {
+        REQUIRE(matches <std::int32_t>(size));
+        REQUIRE(matches <std::int64_t>(size));
+        REQUIRE(matches <float>(size));
+        REQUIRE(matches <double>(size));
+        REQUIRE(matches <short>(size));
+      }
+    }
+  }
+  GIVEN("A Static Index holding the largest key") {
+    std::vector <std::pair <int, int> > elements {{std::numeric_limits <int>::max(), 1}, {0, 2}};
+    forest::static_index <int, int> index(elements.begin(), elements.end());
+    THEN("Test the largest key is found") {
+      REQUIRE(index.search(std::numeric_limits <int>::max())->value == 1);
+      REQUIRE(index.lower_bound(1)->key == std::numeric_limits <int>::max());
+      REQUIRE(index.minimum()->key == 0);
+      REQUIRE(index.maximum()->value == 1);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * @file thread_pool.cpp
+ * @author George Fotopoulos
+ */
+
+#include <catch2/catch.hpp>
+#include <forest/thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+  long sum(forest::thread_pool & pool, long lo, long hi) {
+    if (hi - lo < 16) {
+      long result {0};
+      for (long i = lo; i < hi; i++) {
+        result += i;
+      }
+      return result;
+    }
+    long middle {lo + (hi - lo) / 2};
+    long left {0};
+    long right {0};
+    pool.invoke([&] {
+      left = sum(pool, lo, middle);
+    }, [&] {
+      right = sum(pool, middle, hi);
+    });
+    return left + right;
+  }
+}
+
+SCENARIO("Test Thread Pool") {
+  GIVEN("A Thread Pool") {
+    forest::thread_pool pool(4);
+    WHEN("Tasks are forked recursively") {
+      THEN("Test every task runs") {
+        REQUIRE(pool.size() == 4);
+        REQUIRE(sum(pool, 0, 100000) == 4999950000L);
+      }
+    }
+    WHEN("A task throws") {
+      THEN("Test the exception reaches the caller") {
+        std::atomic <int> runs {0};
+        REQUIRE_THROWS_AS(pool.invoke([&] {
+          runs++;
+        }, [&] {
+          runs++;
+          throw std::runtime_error("task");
+        }), std::runtime_error);
+        REQUIRE(runs == 2);
+      }
+    }
+    WHEN("A range is sorted in parallel") {
+      THEN("Test the sort is stable") {
+        std::vector <std::pair <int, int> > elements;
+        for (int i = 0; i < 100000; i++) {
+          elements.emplace_back((i * 7919) % 1000, i);
+        }
+        std::vector <std::pair <int, int> > expected {elements};
+        auto less = [](const std::pair <int, int> & a, const std::pair <int, int> & b) {
+          return a.first < b.first;
+        };
+        std::stable_sort(expected.begin(), expected.end(), less);
+        forest::parallel_stable_sort(elements.begin(), elements.end(), less, pool);
+        REQUIRE(elements == expected);
+      }
+    }
+  }
+  GIVEN("A Thread Pool without workers") {
+    forest::thread_pool pool(0);
+    WHEN("Tasks are forked recursively") {
+      THEN("Test the caller runs every task") {
+        REQUIRE(sum(pool, 0, 1000) == 499500);
+      }
+    }
+  }
+}